@@ -0,0 +1,49 @@
+// Copyright (C) 2018 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#ifndef FOONATHAN_ARRAY_BENCHMARK_HPP_INCLUDED
+#define FOONATHAN_ARRAY_BENCHMARK_HPP_INCLUDED
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+
+namespace benchmark
+{
+    // prevents the optimizer from removing a computation
+    template <typename T>
+    void do_not_optimize(const T& value)
+    {
+        asm volatile("" : : "r,m"(value) : "memory");
+    }
+
+    // returns the minimal time of the function in nanoseconds
+    template <typename Func>
+    double measure(unsigned repetitions, Func f)
+    {
+        auto result = 1e100;
+        for (auto i = 0u; i != repetitions; ++i)
+        {
+            auto begin = std::chrono::high_resolution_clock::now();
+            f();
+            auto end = std::chrono::high_resolution_clock::now();
+
+            auto duration = std::chrono::duration<double, std::nano>(end - begin).count();
+            result        = std::min(result, duration);
+        }
+        return result;
+    }
+
+    inline void print_header(const char* name)
+    {
+        std::printf("\n%s\n", name);
+    }
+
+    inline void print_result(const char* name, double time, double n)
+    {
+        std::printf("  %-40s %12.3f ms %10.3f ns/element\n", name, time / 1e6, time / n);
+    }
+} // namespace benchmark
+
+#endif // FOONATHAN_ARRAY_BENCHMARK_HPP_INCLUDED
@@ -0,0 +1,114 @@
+// Copyright (C) 2018 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+// compares copying trivially copyable types from a contiguous range, which uses memcpy(),
+// with copying them from a range that isn't contiguous, which copies element wise
+
+#include <vector>
+
+#include <foonathan/array/array.hpp>
+
+#include "benchmark.hpp"
+
+using namespace foonathan::array;
+
+namespace
+{
+    struct pod
+    {
+        int    a;
+        float  b;
+        double c;
+    };
+
+    // a forward iterator over a pointer that isn't recognized as contiguous
+    template <typename T>
+    class forward_iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type        = T;
+        using difference_type   = std::ptrdiff_t;
+        using pointer           = const T*;
+        using reference         = const T&;
+
+        explicit forward_iterator(const T* ptr) : ptr_(ptr) {}
+
+        reference operator*() const
+        {
+            return *ptr_;
+        }
+
+        forward_iterator& operator++()
+        {
+            ++ptr_;
+            return *this;
+        }
+        forward_iterator operator++(int)
+        {
+            auto copy = *this;
+            ++ptr_;
+            return copy;
+        }
+
+        friend bool operator==(forward_iterator lhs, forward_iterator rhs)
+        {
+            return lhs.ptr_ == rhs.ptr_;
+        }
+        friend bool operator!=(forward_iterator lhs, forward_iterator rhs)
+        {
+            return lhs.ptr_ != rhs.ptr_;
+        }
+
+    private:
+        const T* ptr_;
+    };
+
+    // time to append the entire source to an array with enough capacity
+    template <typename Iter, typename T>
+    double append(const std::vector<T>& source)
+    {
+        array<T> a;
+        a.reserve(source.size());
+        return benchmark::measure(10u, [&] {
+            a.clear();
+            a.append_range(Iter(source.data()), Iter(source.data() + source.size()));
+            benchmark::do_not_optimize(a[0]);
+        });
+    }
+
+    template <typename T>
+    double copy_construct(const array<T>& source)
+    {
+        return benchmark::measure(10u, [&] {
+            array<T> copy(source);
+            benchmark::do_not_optimize(copy[0]);
+        });
+    }
+
+    template <typename T>
+    void run(const char* name, std::size_t n)
+    {
+        std::vector<T> source(n, T{});
+        array<T>       source_array;
+        source_array.append_range(source.data(), source.data() + n);
+
+        benchmark::print_header(name);
+        benchmark::print_result("append_range (element wise)",
+                                append<forward_iterator<T>>(source), double(n));
+        benchmark::print_result("append_range (memcpy)", append<const T*>(source), double(n));
+        benchmark::print_result("copy constructor", copy_construct(source_array), double(n));
+    }
+} // namespace
+
+int main()
+{
+    for (auto n : {std::size_t(1) << 12, std::size_t(1) << 16, std::size_t(1) << 20})
+    {
+        std::printf("\n=== n = %zu ===", n);
+        run<int>("int", n);
+        run<double>("double", n);
+        run<pod>("pod", n);
+    }
+}
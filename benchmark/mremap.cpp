@@ -0,0 +1,59 @@
+// Copyright (C) 2018 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+// compares growing a big array by copying with growing it using mremap()
+// usage: foonathan_array_benchmark_mremap [size in MiB, default 1024]
+
+#include <cstdint>
+#include <cstdlib>
+
+#include <foonathan/array/array.hpp>
+#include <foonathan/array/block_storage_mmap.hpp>
+
+#include "benchmark.hpp"
+
+using namespace foonathan::array;
+
+namespace
+{
+    // time of a reserve() that doubles the capacity of a full array
+    template <class BlockStorage>
+    double growth(std::size_t n, const typename BlockStorage::arg_type& args)
+    {
+        auto result = 1e100;
+        for (auto i = 0; i != 5; ++i)
+        {
+            array<std::uint64_t, BlockStorage> a(args);
+            a.reserve(n);
+            while (a.size() != a.capacity())
+                a.push_back(a.size());
+
+            auto time = benchmark::measure(1u, [&] { a.reserve(2 * a.capacity()); });
+            benchmark::do_not_optimize(a.back());
+            result = std::min(result, time);
+        }
+        return result;
+    }
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    auto mib = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1024ul;
+    auto n   = std::size_t(mib) * 1024u * 1024u / sizeof(std::uint64_t);
+    std::printf("\n=== %lu MiB ===", mib);
+
+    benchmark::print_header("growth");
+    benchmark::print_result("copy (block_storage_new)", growth<block_storage_new<>>(n, {}),
+                            double(n));
+#ifdef MREMAP_MAYMOVE
+    benchmark::print_result(
+        "mremap (block_storage_mmap)",
+        growth<block_storage_mmap<>>(n, block_storage_arg(mmap_heap::handle_type(
+                                            mmap_heap::default_threshold,
+                                            huge_page_mode::disabled))),
+        double(n));
+    benchmark::print_result("mremap + huge pages (block_storage_mmap)",
+                            growth<block_storage_mmap<>>(n, {}), double(n));
+#endif
+}
@@ -0,0 +1,72 @@
+// Copyright (C) 2018 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+// compares the throughput of push_back() with std::vector
+
+#include <vector>
+
+#include <foonathan/array/array.hpp>
+
+#include "benchmark.hpp"
+
+using namespace foonathan::array;
+
+namespace
+{
+    struct pod
+    {
+        int    a;
+        float  b;
+        double c;
+    };
+
+    template <typename T>
+    T make(std::size_t i)
+    {
+        return static_cast<T>(i);
+    }
+
+    template <>
+    pod make<pod>(std::size_t i)
+    {
+        return pod{int(i), float(i), double(i)};
+    }
+
+    // time to push n elements into an empty container
+    template <class Container>
+    double push_back(std::size_t n, bool reserve)
+    {
+        using value_type = typename Container::value_type;
+        return benchmark::measure(10u, [&] {
+            Container c;
+            if (reserve)
+                c.reserve(n);
+            for (auto i = 0u; i != n; ++i)
+                c.push_back(make<value_type>(i));
+            benchmark::do_not_optimize(c[n - 1]);
+        });
+    }
+
+    template <typename T>
+    void run(const char* name, std::size_t n)
+    {
+        benchmark::print_header(name);
+        benchmark::print_result("std::vector", push_back<std::vector<T>>(n, false), double(n));
+        benchmark::print_result("array", push_back<array<T>>(n, false), double(n));
+        benchmark::print_result("std::vector (reserved)", push_back<std::vector<T>>(n, true),
+                                double(n));
+        benchmark::print_result("array (reserved)", push_back<array<T>>(n, true), double(n));
+    }
+} // namespace
+
+int main()
+{
+    for (auto n : {std::size_t(1) << 12, std::size_t(1) << 16, std::size_t(1) << 20})
+    {
+        std::printf("\n=== n = %zu ===", n);
+        run<int>("int", n);
+        run<double>("double", n);
+        run<pod>("pod", n);
+    }
+}
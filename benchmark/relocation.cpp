@@ -0,0 +1,94 @@
+// Copyright (C) 2018 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+// compares the reallocation cost of a trivially relocatable type with one that isn't
+
+#include <memory>
+
+#include <foonathan/array/array.hpp>
+
+#include "benchmark.hpp"
+
+using namespace foonathan::array;
+
+namespace
+{
+    // same layout as std::unique_ptr, but not marked as trivially relocatable,
+    // so it uses the element wise move construct + destroy like before
+    struct boxed_int
+    {
+        std::unique_ptr<int> ptr;
+
+        explicit boxed_int(int* ptr) : ptr(ptr) {}
+    };
+
+    static_assert(!is_trivially_relocatable<boxed_int>::value, "");
+    static_assert(is_trivially_relocatable<std::unique_ptr<int>>::value, "");
+
+    template <typename T>
+    array<T> make_full_array(std::size_t n)
+    {
+        array<T> result;
+        result.reserve(n);
+        for (auto i = 0u; i != n; ++i)
+            result.emplace_back(new int(int(i)));
+        result.shrink_to_fit();
+        return result;
+    }
+
+    // time of a reserve() on a full array, i.e. the reallocation
+    template <typename T>
+    double reallocation(std::size_t n)
+    {
+        auto result = 1e100;
+        for (auto i = 0; i != 10; ++i)
+        {
+            auto a    = make_full_array<T>(n);
+            auto time = benchmark::measure(1u, [&] { a.reserve(2 * n); });
+            result    = std::min(result, time);
+        }
+        return result;
+    }
+
+    // time to erase the first half of the elements one by one from the front
+    template <typename T>
+    double erase_front(std::size_t n)
+    {
+        auto result = 1e100;
+        for (auto i = 0; i != 10; ++i)
+        {
+            auto a    = make_full_array<T>(n);
+            auto time = benchmark::measure(1u, [&] {
+                for (auto j = 0u; j != n / 2; ++j)
+                    a.erase(a.begin());
+            });
+            result    = std::min(result, time);
+        }
+        return result;
+    }
+} // namespace
+
+int main()
+{
+    for (auto n : {std::size_t(1) << 12, std::size_t(1) << 16, std::size_t(1) << 20})
+    {
+        std::printf("\n=== n = %zu ===", n);
+
+        benchmark::print_header("reallocation");
+        benchmark::print_result("move + destroy (boxed_int)", reallocation<boxed_int>(n),
+                                double(n));
+        benchmark::print_result("relocation (std::unique_ptr<int>)",
+                                reallocation<std::unique_ptr<int>>(n), double(n));
+
+        if (n <= (std::size_t(1) << 16))
+        {
+            benchmark::print_header("erase from front");
+            auto shifted = double(n / 2) * double(n) * 0.75; // total elements shifted
+            benchmark::print_result("move assign (boxed_int)", erase_front<boxed_int>(n),
+                                    shifted);
+            benchmark::print_result("relocation (std::unique_ptr<int>)",
+                                    erase_front<std::unique_ptr<int>>(n), shifted);
+        }
+    }
+}
@@ -0,0 +1,81 @@
+// Copyright (C) 2018 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+// compares the construction of sets and maps from unsorted integers using the radix sort,
+// with the construction using a comparison sort
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include <foonathan/array/flat_map.hpp>
+#include <foonathan/array/flat_set.hpp>
+
+#include "benchmark.hpp"
+
+using namespace foonathan::array;
+
+namespace
+{
+    // same as key_compare_default, but without a radix key
+    struct comparison_only
+    {
+        template <typename Key, typename TransparentKey>
+        static auto compare(const Key& k, const TransparentKey& t) noexcept
+            -> decltype(key_compare_default::compare(k, t))
+        {
+            return key_compare_default::compare(k, t);
+        }
+    };
+
+    static_assert(key_compare_radix<key_compare_default, std::uint64_t>::value, "");
+    static_assert(!key_compare_radix<comparison_only, std::uint64_t>::value, "");
+
+    template <class Compare>
+    double set_assign(const std::vector<std::uint64_t>& keys)
+    {
+        return benchmark::measure(3u, [&] {
+            flat_set<std::uint64_t, Compare> set;
+            set.assign_range(keys.begin(), keys.end());
+            benchmark::do_not_optimize(set.min());
+        });
+    }
+
+    template <class Compare>
+    double map_assign(const std::vector<std::uint64_t>& keys, const std::vector<int>& values)
+    {
+        return benchmark::measure(3u, [&] {
+            flat_map<std::uint64_t, int, Compare> map;
+            map.assign_range(keys.begin(), keys.end(), values.begin(), values.end());
+            benchmark::do_not_optimize(map.values()[0]);
+        });
+    }
+} // namespace
+
+int main()
+{
+    std::mt19937_64 engine(42u);
+    for (auto n : {std::size_t(1) << 12, std::size_t(1) << 16, std::size_t(1) << 22})
+    {
+        std::printf("\n=== n = %zu ===", n);
+
+        std::vector<std::uint64_t> keys(n);
+        std::vector<int>           values(n);
+        for (auto i = 0u; i != n; ++i)
+        {
+            keys[i]   = engine();
+            values[i] = int(i);
+        }
+
+        benchmark::print_header("flat_set<std::uint64_t>::assign_range");
+        benchmark::print_result("comparison sort", set_assign<comparison_only>(keys), double(n));
+        benchmark::print_result("radix sort", set_assign<key_compare_default>(keys), double(n));
+
+        benchmark::print_header("flat_map<std::uint64_t, int>::assign_range");
+        benchmark::print_result("comparison sort", map_assign<comparison_only>(keys, values),
+                                double(n));
+        benchmark::print_result("radix sort", map_assign<key_compare_default>(keys, values),
+                                double(n));
+    }
+}
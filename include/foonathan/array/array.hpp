@@ -8,6 +8,7 @@
 #include <foonathan/array/block_storage.hpp>
 #include <foonathan/array/block_storage_new.hpp>
 #include <foonathan/array/array_view.hpp>
+#include <foonathan/array/config.hpp>
 #include <foonathan/array/input_view.hpp>
 #include <foonathan/array/pointer_iterator.hpp>
 
@@ -15,6 +16,11 @@ namespace foonathan
 {
     namespace array
     {
+        /// Tag type and object to create an [array::array]() with value initialized elements.
+        constexpr struct value_init_t
+        {
+        } value_init;
+
         /// An array of elements.
         ///
         /// This is the `[std::vector]()` implementation, but uses a `BlockStorage`.
@@ -62,10 +68,20 @@ namespace foonathan
                 end_          = new_view.block().end();
             }
 
+            /// \effects Creates an array containing `n` value initialized elements.
+            /// The block storage is initialized with the given arguments.
+            /// \notes If `T` is [array::is_trivially_value_initializable]() and the `BlockStorage` is [array::block_storage_reserve_zeroed](),
+            /// it requests zeroed memory instead of initializing each element.
+            array(size_type n, value_init_t, typename block_storage::arg_type args = {})
+            : array(std::move(args))
+            {
+                resize(n);
+            }
+
             /// Copy constructor.
             array(const array& other) : array(other.storage_.arguments())
             {
-                append_range(other.begin(), other.end());
+                copy_impl(copy_on_write{}, other);
             }
 
             /// Move constructor.
@@ -86,24 +102,20 @@ namespace foonathan
             /// Destructor.
             ~array() noexcept
             {
-                destroy_range(begin(), end());
+                destroy_impl(copy_on_write{});
             }
 
             /// Copy assignment operator.
             array& operator=(const array& other)
             {
-                auto new_view = copy_assign(storage_, view(), other.storage_, other.view());
-                end_          = new_view.block().end();
+                copy_assign_impl(copy_on_write{}, other);
                 return *this;
             }
 
             /// Move assignment operator.
             array& operator=(array&& other) noexcept(block_storage_nothrow_move<BlockStorage, T>{})
             {
-                auto new_view =
-                    move_assign(storage_, view(), std::move(other.storage_), other.view());
-                end_       = new_view.block().end();
-                other.end_ = other.storage_.block().begin();
+                move_assign_impl(copy_on_write{}, std::move(other));
                 return *this;
             }
 
@@ -127,8 +139,11 @@ namespace foonathan
 
             //=== access ===//
             /// \returns An array view to the elements.
-            operator array_view<T>() noexcept
+            /// \notes If the `BlockStorage` is [array::block_storage_copy_on_write](),
+            /// this and all other non-`const` member functions copy the elements if they are shared.
+            operator array_view<T>() noexcept(nothrow_unshare::value)
             {
+                unshare();
                 return view();
             }
             /// \returns A `const` array view to the elements.
@@ -138,15 +153,17 @@ namespace foonathan
             }
 
             /// \returns An input view to the elements.
-            operator input_view<T, BlockStorage>() && noexcept
+            operator input_view<T, BlockStorage>() && noexcept(nothrow_unshare::value)
             {
+                unshare();
                 auto result = input_view<T, BlockStorage>(std::move(storage_), view());
                 end_        = storage_.empty_block().begin();
                 return result;
             }
 
-            iterator begin() noexcept
+            iterator begin() noexcept(nothrow_unshare::value)
             {
+                unshare();
                 return iterator(iterator_tag{}, view().data());
             }
             const_iterator begin() const noexcept
@@ -158,8 +175,9 @@ namespace foonathan
                 return const_iterator(iterator_tag{}, view().data());
             }
 
-            iterator end() noexcept
+            iterator end() noexcept(nothrow_unshare::value)
             {
+                unshare();
                 return iterator(iterator_tag{}, view().data_end());
             }
             const_iterator end() const noexcept
@@ -171,8 +189,9 @@ namespace foonathan
                 return const_iterator(iterator_tag{}, view().data_end());
             }
 
-            T& operator[](size_type i) noexcept
+            T& operator[](size_type i) noexcept(nothrow_unshare::value)
             {
+                unshare();
                 return view()[i];
             }
             const T& operator[](size_type i) const noexcept
@@ -180,8 +199,9 @@ namespace foonathan
                 return view()[i];
             }
 
-            T& front() noexcept
+            T& front() noexcept(nothrow_unshare::value)
             {
+                unshare();
                 return view().front();
             }
             const T& front() const noexcept
@@ -189,8 +209,9 @@ namespace foonathan
                 return view().front();
             }
 
-            T& back() noexcept
+            T& back() noexcept(nothrow_unshare::value)
             {
+                unshare();
                 return view().back();
             }
             const T& back() const noexcept
@@ -212,10 +233,11 @@ namespace foonathan
             }
 
             /// \returns The number of elements the array can contain without reserving new memory.
+            /// \notes The memory block can be bigger than a whole number of elements,
+            /// e.g. if the heap rounds the size up, the remaining bytes aren't used.
             size_type capacity() const noexcept
             {
-                return size_type(to_pointer<T>(storage_.block().end())
-                                 - to_pointer<T>(storage_.block().begin()));
+                return storage_.block().size() / sizeof(T);
             }
 
             /// \returns The maximum number of elements as determined by the block storage.
@@ -224,9 +246,16 @@ namespace foonathan
                 return BlockStorage::max_size(storage_.arguments()) / sizeof(T);
             }
 
+            /// \returns The arguments the block storage was initialized with.
+            typename block_storage::arg_type block_storage_args() const noexcept
+            {
+                return storage_.arguments();
+            }
+
             /// \effects Reserves new memory to make capacity as least as big as `new_capacity` if that isn't the case already.
             void reserve(size_type new_capacity)
             {
+                unshare();
                 auto cur_cap_bytes = storage_.block().size();
                 auto new_cap_bytes = new_capacity * sizeof(T);
 
@@ -237,6 +266,7 @@ namespace foonathan
             /// \effects Non-binding request to make the capacity as small as necessary.
             void shrink_to_fit()
             {
+                unshare();
                 end_ = storage_.shrink_to_fit(view());
             }
 
@@ -246,7 +276,10 @@ namespace foonathan
             template <typename... Args>
             T& emplace_back(Args&&... args)
             {
-                reserve(size() + 1u);
+                unshare();
+                if (std::size_t(storage_.block().end() - end_) < sizeof(T))
+                    grow_by_one();
+
                 auto ptr = construct_object<T>(end_, std::forward<Args>(args)...);
                 end_ += sizeof(T);
                 return *ptr;
@@ -275,26 +308,21 @@ namespace foonathan
                 // when the capacity is sufficient, this is almost as efficient as possible,
                 // just one extra swap or so
                 //
-                // when the capacity isn't sufficient, the block storage could in theory leave a hole already,
-                // however this would vastly complicate the interface and just isn't worth it,
-                // as it is the slow path anyway
+                // when the capacity isn't sufficient, the block storage can leave a hole already,
+                // if it supports reserve_with_gap(), so the following elements are only moved once
 
                 auto index = size_type(pos - cbegin());
+                unshare();
                 if (index == size())
                     // just do an emplace back
                     emplace_back(std::forward<Args>(args)...);
+                else if (capacity() == size())
+                    emplace_grow(can_leave_gap{}, index, std::forward<Args>(args)...);
                 else
-                {
-                    // reserve for one more element
-                    reserve(size() + 1u);
-                    auto ptr = view().data() + index;
-
-                    // move all elements following it one over
-                    move_range(ptr, view().data_end(), ptr + 1);
-
-                    // create the element at the now empty position
-                    emplace_impl(ptr, std::forward<Args>(args)...);
-                }
+                    // move all elements following it one over,
+                    // then create the element at the now empty position
+                    insert_impl(is_trivially_relocatable<T>{}, view().data() + index,
+                                std::forward<Args>(args)...);
 
                 return begin() + index;
             }
@@ -344,73 +372,273 @@ namespace foonathan
             }
 
             /// \effects Destroys all elements.
+            /// If the `BlockStorage` requests [array::block_storage_auto_shrink](), it also calls `shrink_to_fit()`,
+            /// this applies to all functions removing elements.
             void clear() noexcept
             {
+                release_shared(copy_on_write{});
                 destroy_range(begin(), end());
                 end_ = storage_.block().begin();
+                auto_shrink(block_storage_auto_shrink<BlockStorage>{});
             }
 
             /// \effects Same as `erase(std::prev(end())`.
-            void pop_back() noexcept
+            void pop_back() noexcept(nothrow_unshare::value)
             {
+                unshare();
                 end_ = destroy_object(&*std::prev(end()));
+                auto_shrink(block_storage_auto_shrink<BlockStorage>{});
             }
 
             /// \effects Destroys and removes the element at the given position.
             /// \returns An iterator after the element that was removed.
-            iterator erase(const_iterator pos) noexcept(std::is_nothrow_move_assignable<T>::value)
+            iterator erase(const_iterator pos) noexcept(nothrow_erase::value)
             {
-                auto mut_pos = const_cast<T*>(iterator_to_pointer(pos));
+                auto index = pos - cbegin();
+                unshare();
+                auto mut_pos = view().data() + index;
 
-                // move all elements after to the front
-                std::move(std::next(mut_pos), view().data_end(), mut_pos);
-                // destroy the last element
-                pop_back();
+                // move all elements after to the front, destroying the element
+                erase_impl(is_trivially_relocatable<T>{}, mut_pos, std::next(mut_pos));
+                auto_shrink(block_storage_auto_shrink<BlockStorage>{});
 
                 // next element after is at the location of pos
-                return iterator(iterator_tag{}, mut_pos);
+                return begin() + index;
             }
 
             /// \effects Destroys and removes all elements in the range `[begin, end)`.
             /// \returns An iterator after the last element that was removed.
-            iterator erase_range(const_iterator begin, const_iterator end) noexcept(
-                std::is_nothrow_move_assignable<T>::value)
+            iterator erase_range(const_iterator begin,
+                                 const_iterator end) noexcept(nothrow_erase::value)
             {
-                auto mut_begin = const_cast<T*>(iterator_to_pointer(begin));
-                auto mut_end   = const_cast<T*>(iterator_to_pointer(end));
+                auto index     = begin - cbegin();
+                auto end_index = end - cbegin();
+                unshare();
+                auto mut_begin = view().data() + index;
+                auto mut_end   = view().data() + end_index;
 
                 if (mut_begin != mut_end)
                 {
-                    // move all elements after to the front
-                    std::move(mut_end, view().data_end(), mut_begin);
-
-                    // destroy the elements at the end
-                    auto n = mut_end - mut_begin;
-                    destroy_range(std::prev(view().data_end(), n), view().data_end());
-                    end_ -= std::size_t(n) * sizeof(T);
+                    // move all elements after to the front, destroying the elements in the range
+                    erase_impl(is_trivially_relocatable<T>{}, mut_begin, mut_end);
+                    auto_shrink(block_storage_auto_shrink<BlockStorage>{});
                 }
 
                 // next element after is still the first location of the range
-                return iterator(iterator_tag{}, mut_begin);
+                return this->begin() + index;
             }
 
             /// \effects Conceptually the same as `*this = array<T>(block)`.
+            /// If an exception is thrown, it will be empty.
             void assign(input_view<T, BlockStorage>&& block)
             {
-                auto new_view = std::move(block).release(storage_, view());
-                new_view      = move_to_front(storage_, new_view);
-                end_          = new_view.block().end();
+                release_shared(copy_on_write{});
+                try
+                {
+                    auto new_view = std::move(block).release(storage_, view());
+                    new_view      = move_to_front(storage_, new_view);
+                    end_          = new_view.block().end();
+                }
+                catch (...)
+                {
+                    // the objects have been destroyed already
+                    end_ = storage_.block().begin();
+                    throw;
+                }
             }
 
             /// \effects Conceptually the same as `array<T> a; a.insert_range(begin, end); *this = std::move(a);`
+            /// If an exception is thrown, it will be empty.
             template <typename InputIt>
             void assign_range(InputIt begin, InputIt end)
             {
-                auto new_view = assign_copy(storage_, view(), begin, end);
-                end_          = new_view.block().end();
+                release_shared(copy_on_write{});
+                try
+                {
+                    auto new_view = assign_copy(storage_, view(), begin, end);
+                    end_          = new_view.block().end();
+                }
+                catch (...)
+                {
+                    // the objects have been destroyed already
+                    end_ = storage_.block().begin();
+                    throw;
+                }
+            }
+
+            /// \effects Changes the number of elements to `new_size`,
+            /// by destroying elements at the end or appending value initialized ones.
+            /// \notes Like the constructor, it requests zeroed memory if it needs to reserve and can.
+            void resize(size_type new_size)
+            {
+                if (new_size <= size())
+                    destroy_back(new_size);
+                else
+                    append_value_init(reserve_zeroed{}, new_size);
+            }
+
+            /// \effects Changes the number of elements to `new_size`,
+            /// by destroying elements at the end or appending default initialized ones.
+            /// \notes Unlike `resize()`, this leaves new elements of trivial types uninitialized.
+            void resize_default_init(size_type new_size)
+            {
+                if (new_size <= size())
+                    destroy_back(new_size);
+                else
+                {
+                    reserve(new_size);
+                    end_ = uninitialized_default_construct<T>(free_memory(), new_size - size());
+                }
+            }
+
+            /// \effects Appends `n` elements with indeterminate values.
+            /// \returns A view to the new elements, the caller has to write them,
+            /// e.g. by passing it to `read()`.
+            /// \requires `T` must be trivially default constructible.
+            array_view<T> append_uninitialized(size_type n)
+            {
+                static_assert(std::is_trivially_default_constructible<T>::value,
+                              "elements must not require initialization");
+                auto index = size();
+                resize_default_init(index + n);
+                return array_view<T>(view().data() + index, n);
             }
 
         private:
+            using copy_on_write   = block_storage_copy_on_write<BlockStorage>;
+            using nothrow_unshare = std::integral_constant<bool, !copy_on_write::value>;
+            using nothrow_erase =
+                std::integral_constant<bool, nothrow_unshare::value
+                                                 && (is_trivially_relocatable<T>::value
+                                                     || std::is_nothrow_move_assignable<T>::value)>;
+
+            void copy_impl(std::true_type, const array& other) noexcept
+            {
+                end_ = storage_.share(other.storage_, other.view());
+            }
+            void copy_impl(std::false_type, const array& other)
+            {
+                append_range(other.begin(), other.end());
+            }
+
+            void destroy_impl(std::true_type) noexcept
+            {
+                storage_.release(view());
+            }
+            void destroy_impl(std::false_type) noexcept
+            {
+                destroy_range(begin(), end());
+            }
+
+            void copy_assign_impl(std::true_type, const array& other)
+            {
+                array tmp(other);
+                swap(*this, tmp);
+            }
+            void copy_assign_impl(std::false_type, const array& other)
+            {
+                auto new_view = copy_assign(storage_, view(), other.storage_, other.view());
+                end_          = new_view.block().end();
+            }
+
+            void move_assign_impl(std::true_type, array&& other) noexcept
+            {
+                // the elements could be shared, so just let the destructor release them
+                array tmp(std::move(other));
+                swap(*this, tmp);
+            }
+            void move_assign_impl(std::false_type, array&& other) noexcept(
+                block_storage_nothrow_move<BlockStorage, T>{})
+            {
+                auto new_view =
+                    move_assign(storage_, view(), std::move(other.storage_), other.view());
+                end_       = new_view.block().end();
+                other.end_ = other.storage_.block().begin();
+            }
+
+            // the slow path of emplace_back(), kept out of line so the check for capacity can be inlined
+            FOONATHAN_ARRAY_NOINLINE void grow_by_one()
+            {
+                reserve(size() + 1u);
+            }
+
+            // makes sure the elements can be modified
+            void unshare() noexcept(nothrow_unshare::value)
+            {
+                unshare_impl(copy_on_write{});
+            }
+            void unshare_impl(std::true_type)
+            {
+                end_ = storage_.unshare(view());
+            }
+            void unshare_impl(std::false_type) noexcept {}
+
+            // gives up shared elements without copying, as they aren't needed anymore
+            void release_shared(std::true_type) noexcept
+            {
+                if (storage_.is_shared())
+                {
+                    storage_.release(view());
+                    end_ = storage_.block().begin();
+                }
+            }
+            void release_shared(std::false_type) noexcept {}
+
+            using reserve_zeroed =
+                std::integral_constant<bool, is_trivially_value_initializable<T>::value
+                                                 && block_storage_reserve_zeroed<BlockStorage,
+                                                                                 T>::value>;
+
+            void append_value_init(std::true_type, size_type new_size)
+            {
+                if (new_size > capacity())
+                {
+                    unshare();
+                    end_ = storage_.reserve_zeroed(new_size * sizeof(T) - storage_.block().size(),
+                                                   view());
+                    // the memory is zero, so the objects are already there
+                    end_ += (new_size - size()) * sizeof(T);
+                }
+                else
+                    end_ = uninitialized_value_construct<T>(free_memory(), new_size - size());
+            }
+            void append_value_init(std::false_type, size_type new_size)
+            {
+                reserve(new_size);
+                end_ = uninitialized_value_construct<T>(free_memory(), new_size - size());
+            }
+
+            memory_block free_memory() const noexcept
+            {
+                return memory_block(end_, storage_.block().end());
+            }
+
+            // destroys all elements after the first new_size ones
+            void destroy_back(size_type new_size) noexcept(nothrow_unshare::value)
+            {
+                if (new_size == size())
+                    return;
+
+                unshare();
+                auto new_end = view().data() + new_size;
+                destroy_range(new_end, view().data_end());
+                end_ = to_raw_pointer(new_end);
+                auto_shrink(block_storage_auto_shrink<BlockStorage>{});
+            }
+
+            void auto_shrink(std::true_type) noexcept
+            {
+                try
+                {
+                    shrink_to_fit();
+                }
+                catch (...)
+                {
+                    // shrink_to_fit() is non-binding anyway
+                }
+            }
+            void auto_shrink(std::false_type) noexcept {}
+
             array_view<T> view() const noexcept
             {
                 assert(end_ <= storage_.block().end());
@@ -436,6 +664,50 @@ namespace foonathan
                 std::move_backward(from_begin, assign_end, cur_end);
             }
 
+            template <typename... Args>
+            void insert_impl(std::true_type, T* ptr, Args&&... args)
+            {
+                // relocate the elements one over, leaving a hole at ptr
+                auto old_end = view().data_end();
+                detail::relocate_overlapping(ptr, old_end, ptr + 1);
+
+                try
+                {
+                    construct_object<T>(to_raw_pointer(ptr), std::forward<Args>(args)...);
+                }
+                catch (...)
+                {
+                    // close the hole again
+                    detail::relocate_overlapping(ptr + 1, old_end + 1, ptr);
+                    throw;
+                }
+                end_ += sizeof(T);
+            }
+            template <typename... Args>
+            void insert_impl(std::false_type, T* ptr, Args&&... args)
+            {
+                move_range(ptr, view().data_end(), ptr + 1);
+                emplace_impl(ptr, std::forward<Args>(args)...);
+            }
+
+            void erase_impl(std::true_type, T* begin, T* end) noexcept
+            {
+                // destroy the elements, then relocate the following ones into the hole
+                destroy_range(begin, end);
+                detail::relocate_overlapping(end, view().data_end(), begin);
+                end_ -= std::size_t(end - begin) * sizeof(T);
+            }
+            void erase_impl(std::false_type, T* begin,
+                            T* end) noexcept(std::is_nothrow_move_assignable<T>::value)
+            {
+                // move all elements after to the front
+                auto new_end = std::move(end, view().data_end(), begin);
+
+                // destroy the elements at the end
+                destroy_range(new_end, view().data_end());
+                end_ = to_raw_pointer(new_end);
+            }
+
             template <typename Arg>
             static auto emplace_impl(T* ptr, Arg&& arg) -> decltype(*ptr = std::forward<Arg>(arg))
             {
@@ -465,11 +737,7 @@ namespace foonathan
                 reserve(size() + needed);
 
                 auto iter = this->end();
-                for (auto cur = begin; cur != end; ++cur)
-                {
-                    construct_object<T>(end_, *cur);
-                    end_ += sizeof(T);
-                }
+                end_      = copy_range(begin, end, free_memory());
                 return iter;
             }
 
@@ -490,13 +758,147 @@ namespace foonathan
             iterator insert_range_impl(const_iterator pos, std::forward_iterator_tag,
                                        ForwardIt begin, ForwardIt end)
             {
-                auto index = pos - this->begin();
+                auto index  = size_type(pos - cbegin());
+                auto needed = size_type(std::distance(begin, end));
+                unshare();
+                if (capacity() - size() < needed)
+                    insert_range_grow(can_leave_gap{}, index, needed, begin, end);
+                else
+                    insert_range_impl(is_trivially_relocatable<T>{}, index, needed, begin, end);
+                return this->begin() + std::ptrdiff_t(index);
+            }
+
+            template <typename ForwardIt>
+            void insert_range_grow(std::true_type, size_type index, size_type needed,
+                                   ForwardIt begin, ForwardIt end)
+            {
+                fill_gap(reserve_with_gap(index, needed), needed, begin, end);
+            }
+            template <typename ForwardIt>
+            void insert_range_grow(std::false_type, size_type index, size_type needed,
+                                   ForwardIt begin, ForwardIt end)
+            {
+                insert_range_impl(is_trivially_relocatable<T>{}, index, needed, begin, end);
+            }
 
+            template <typename ForwardIt>
+            void insert_range_impl(std::true_type, size_type index, size_type needed,
+                                   ForwardIt begin, ForwardIt end)
+            {
+                reserve(size() + needed);
+
+                // relocate the elements over, leaving a hole for the new ones
+                auto ptr = view().data() + index;
+                detail::relocate_overlapping(ptr, view().data_end(), ptr + needed);
+                end_ += needed * sizeof(T);
+
+                fill_gap(to_raw_pointer(ptr), needed, begin, end);
+            }
+            template <typename ForwardIt>
+            void insert_range_impl(std::false_type, size_type index, size_type, ForwardIt begin,
+                                   ForwardIt end)
+            {
                 // just do an append plus rotate
                 auto new_begin = append_range(begin, end);
-                std::rotate(this->begin() + index, new_begin, this->end());
+                std::rotate(this->begin() + std::ptrdiff_t(index), new_begin, this->end());
+            }
 
-                return this->begin() + index;
+            // whether or not we can use reserve_with_gap(),
+            // closing the gap again on exceptions must not throw
+            using can_leave_gap =
+                std::integral_constant<bool, block_storage_reserve_with_gap<BlockStorage, T>::value
+                                                 && (is_trivially_relocatable<T>::value
+                                                     || std::is_nothrow_move_constructible<
+                                                            T>::value)>;
+
+            template <typename... Args>
+            void emplace_grow(std::true_type, size_type index, Args&&... args)
+            {
+                auto gap = reserve_with_gap(index, 1u);
+                try
+                {
+                    construct_object<T>(gap, std::forward<Args>(args)...);
+                }
+                catch (...)
+                {
+                    close_gap(gap, 1u);
+                    throw;
+                }
+            }
+            template <typename... Args>
+            void emplace_grow(std::false_type, size_type index, Args&&... args)
+            {
+                reserve(size() + 1u);
+                insert_impl(is_trivially_relocatable<T>{}, view().data() + index,
+                            std::forward<Args>(args)...);
+            }
+
+            // reserves memory for n more elements, leaving them as a gap at the index
+            // returns a pointer to the gap, which is already part of [begin, end_)
+            raw_pointer reserve_with_gap(size_type index, size_type n)
+            {
+                end_ = storage_.reserve_with_gap(index, n * sizeof(T), view());
+                return storage_.block().begin() + index * sizeof(T);
+            }
+
+            // copies the range into the gap of n elements, closing it again on exceptions
+            template <typename ForwardIt>
+            void fill_gap(raw_pointer gap, size_type n, ForwardIt begin, ForwardIt end)
+            {
+                try
+                {
+                    copy_range(begin, end, memory_block(gap, n * sizeof(T)));
+                }
+                catch (...)
+                {
+                    close_gap(gap, n);
+                    throw;
+                }
+            }
+
+            // moves the elements after the gap of n elements back, so it is removed again
+            void close_gap(raw_pointer gap, size_type n) noexcept
+            {
+                close_gap(is_trivially_relocatable<T>{}, to_pointer<T>(gap), n);
+                end_ -= n * sizeof(T);
+            }
+            void close_gap(std::true_type, T* gap, size_type n) noexcept
+            {
+                detail::relocate_overlapping(gap + n, view().data_end(), gap);
+            }
+            void close_gap(std::false_type, T* gap, size_type n) noexcept
+            {
+                for (auto cur = gap + n; cur != view().data_end(); ++cur)
+                {
+                    construct_object<T>(to_raw_pointer(cur - n), std::move(*cur));
+                    cur->~T();
+                }
+            }
+
+            // copies the range into the memory, using memcpy() if possible
+            // only if the iterator yields lvalues of T, so move iterators still move
+            template <typename ForwardIt>
+            static raw_pointer copy_range(ForwardIt begin, ForwardIt end, const memory_block& block)
+            {
+                using reference = typename std::iterator_traits<ForwardIt>::reference;
+                using copies_lvalues =
+                    std::integral_constant<bool,
+                                           std::is_lvalue_reference<reference>::value
+                                               && std::is_same<typename std::decay<reference>::type,
+                                                               T>::value>;
+                return copy_range(copies_lvalues{}, begin, end, block);
+            }
+            template <typename ForwardIt>
+            static raw_pointer copy_range(std::true_type, ForwardIt begin, ForwardIt end,
+                                          const memory_block& block)
+            {
+                return uninitialized_copy(begin, end, block);
+            }
+            template <typename ForwardIt>
+            static raw_pointer copy_range(std::false_type, ForwardIt begin, ForwardIt end,
+                                          const memory_block& block)
+            {
+                return uninitialized_copy_convert<T>(begin, end, block);
             }
 
             BlockStorage storage_;
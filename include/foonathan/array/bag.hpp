@@ -70,7 +70,7 @@ namespace foonathan
 
             //=== access ===//
             /// \returns A block view to the elements.
-            operator block_view<T>() noexcept
+            operator block_view<T>() noexcept(nothrow_unshare::value)
             {
                 return array_;
             }
@@ -81,12 +81,12 @@ namespace foonathan
             }
 
             /// \returns An input view to the elements.
-            operator input_view<T, BlockStorage>() && noexcept
+            operator input_view<T, BlockStorage>() && noexcept(nothrow_unshare::value)
             {
                 return std::move(array_).operator input_view<T, BlockStorage>();
             }
 
-            iterator begin() noexcept
+            iterator begin() noexcept(nothrow_unshare::value)
             {
                 return iterator(iterator_tag{}, iterator_to_pointer(array_.begin()));
             }
@@ -99,7 +99,7 @@ namespace foonathan
                 return const_iterator(iterator_tag{}, iterator_to_pointer(array_.begin()));
             }
 
-            iterator end() noexcept
+            iterator end() noexcept(nothrow_unshare::value)
             {
                 return iterator(iterator_tag{}, iterator_to_pointer(array_.end()));
             }
@@ -193,10 +193,11 @@ namespace foonathan
 
             /// \effects Destroys and removes the element at the given position.
             /// \returns An iterator after the element that was removed.
-            iterator erase(const_iterator iter) noexcept(std::is_nothrow_swappable<T>{})
+            iterator erase(const_iterator iter) noexcept(nothrow_unshare::value
+                                                         && std::is_nothrow_swappable<T>{})
             {
-                // const_cast is fine, no element was const
-                auto ptr = const_cast<T*>(iterator_to_pointer(iter));
+                // use the index, the elements might be copied if they were shared
+                auto ptr = iterator_to_pointer(begin()) + (iter - cbegin());
 
                 // swap with the last element, if it is not already last
                 auto ptr_last = &array_.back();
@@ -212,13 +213,13 @@ namespace foonathan
 
             /// \effects Destroys all elements in the range `[begin, end)`.
             /// \returns An iterator after the last element that was removed.
-            iterator erase_range(const_iterator begin,
-                                 const_iterator end) noexcept(std::is_nothrow_move_assignable<T>{})
+            iterator erase_range(const_iterator begin, const_iterator end) noexcept(
+                nothrow_unshare::value && std::is_nothrow_move_assignable<T>{})
             {
-                // again, const_cast is fine
-                auto begin_ptr = const_cast<T*>(iterator_to_pointer(begin));
-                auto end_ptr   = const_cast<T*>(iterator_to_pointer(end));
-                auto count     = end_ptr - begin_ptr;
+                // again, use the index
+                auto begin_ptr = iterator_to_pointer(this->begin()) + (begin - cbegin());
+                auto count     = end - begin;
+                auto end_ptr   = begin_ptr + count;
 
                 auto view = block_view<T>(*this);
 
@@ -267,6 +268,9 @@ namespace foonathan
             }
 
         private:
+            using nothrow_unshare =
+                std::integral_constant<bool, !block_storage_copy_on_write<BlockStorage>::value>;
+
             array<T, BlockStorage> array_;
         };
     } // namespace array
@@ -141,6 +141,109 @@ namespace foonathan
             std::integral_constant<bool, !BlockStorage::embedded_storage::value
                                              || std::is_nothrow_move_constructible<T>::value>;
 
+        namespace detail
+        {
+            template <class BlockStorage, typename = void>
+            struct block_storage_auto_shrink_impl : std::false_type
+            {
+            };
+
+            template <class BlockStorage>
+            struct block_storage_auto_shrink_impl<BlockStorage,
+                                                  decltype(void(BlockStorage::auto_shrink::value))>
+            : BlockStorage::auto_shrink
+            {
+            };
+        } // namespace detail
+
+        /// `std::true_type` if containers should call `shrink_to_fit()` after removing elements, `std::false_type` otherwise.
+        ///
+        /// A `BlockStorage` can request it with the optional `auto_shrink` typedef.
+        template <class BlockStorage>
+        using block_storage_auto_shrink =
+            std::integral_constant<bool,
+                                   detail::block_storage_auto_shrink_impl<BlockStorage>::value>;
+
+        namespace detail
+        {
+            template <class BlockStorage, typename = void>
+            struct block_storage_copy_on_write_impl : std::false_type
+            {
+            };
+
+            template <class BlockStorage>
+            struct block_storage_copy_on_write_impl<
+                BlockStorage, decltype(void(BlockStorage::copy_on_write::value))>
+            : BlockStorage::copy_on_write
+            {
+            };
+        } // namespace detail
+
+        /// `std::true_type` if copies of a container share the memory of a `BlockStorage`, `std::false_type` otherwise.
+        ///
+        /// A `BlockStorage` requests it with the optional `copy_on_write` typedef,
+        /// it must then provide `is_shared()`, `share()`, `unshare()` and `release()`
+        /// like [array::block_storage_cow]().
+        template <class BlockStorage>
+        using block_storage_copy_on_write =
+            std::integral_constant<bool,
+                                   detail::block_storage_copy_on_write_impl<BlockStorage>::value>;
+
+        namespace detail
+        {
+            template <class BlockStorage, typename T, typename = void>
+            struct block_storage_reserve_zeroed_impl : std::false_type
+            {
+            };
+
+            template <class BlockStorage, typename T>
+            struct block_storage_reserve_zeroed_impl<
+                BlockStorage, T,
+                decltype(void(std::declval<BlockStorage&>().reserve_zeroed(
+                    size_type(0), std::declval<const block_view<T>&>())))> : std::true_type
+            {
+            };
+        } // namespace detail
+
+        /// `std::true_type` if a `BlockStorage` can provide zeroed memory for objects of type `T`, `std::false_type` otherwise.
+        ///
+        /// A `BlockStorage` supports it with the optional `reserve_zeroed()` function,
+        /// which is like `reserve()` but the memory after the constructed objects is zeroed,
+        /// like [array::block_storage_heap]() with a `Heap` that provides `allocate_zeroed()`.
+        template <class BlockStorage, typename T>
+        using block_storage_reserve_zeroed =
+            std::integral_constant<bool,
+                                   detail::block_storage_reserve_zeroed_impl<BlockStorage,
+                                                                             T>::value>;
+
+        namespace detail
+        {
+            template <class BlockStorage, typename T, typename = void>
+            struct block_storage_reserve_with_gap_impl : std::false_type
+            {
+            };
+
+            template <class BlockStorage, typename T>
+            struct block_storage_reserve_with_gap_impl<
+                BlockStorage, T,
+                decltype(void(std::declval<BlockStorage&>().reserve_with_gap(
+                    size_type(0), size_type(0), std::declval<const block_view<T>&>())))>
+            : std::true_type
+            {
+            };
+        } // namespace detail
+
+        /// `std::true_type` if a `BlockStorage` can leave a gap between objects of type `T` when it reserves memory, `std::false_type` otherwise.
+        ///
+        /// A `BlockStorage` supports it with the optional `reserve_with_gap(position, gap_bytes, constructed)` function,
+        /// which is like `reserve(gap_bytes, constructed)` but leaves `gap_bytes` uninitialized bytes before the object at index `position`.
+        /// Containers use it to insert in the middle without moving the following objects twice.
+        template <class BlockStorage, typename T>
+        using block_storage_reserve_with_gap =
+            std::integral_constant<bool,
+                                   detail::block_storage_reserve_with_gap_impl<BlockStorage,
+                                                                               T>::value>;
+
         /// \effects Clears a block storage by destroying all constructed objects and releasing the memory.
         template <class BlockStorage, typename T>
         void clear_and_shrink(BlockStorage& storage, block_view<T> constructed) noexcept
@@ -173,6 +276,37 @@ namespace foonathan
                 return storage.reserve(new_size - storage.block().size(), block_view<T>());
         }
 
+        namespace detail
+        {
+            template <class BlockStorage, typename T>
+            block_view<T> move_to_front_overlapping(std::true_type, BlockStorage& storage,
+                                                    block_view<T>  constructed,
+                                                    std::ptrdiff_t) noexcept
+            {
+                auto begin = to_pointer<T>(storage.block().begin());
+                relocate_overlapping(constructed.data(), constructed.data_end(), begin);
+                return block_view<T>(begin, constructed.size());
+            }
+
+            template <class BlockStorage, typename T>
+            block_view<T> move_to_front_overlapping(
+                std::false_type, BlockStorage& storage, block_view<T> constructed,
+                std::ptrdiff_t offset) noexcept(std::is_nothrow_move_constructible<T>::value)
+            {
+                // move construct the first offset elements at the correct location
+                auto mid = constructed.begin() + offset / std::ptrdiff_t(sizeof(T));
+                uninitialized_move(constructed.begin(), mid, storage.block());
+
+                // now we can assign the next elements to the already moved ones
+                auto new_end = std::move(mid, constructed.end(), constructed.begin());
+
+                // destroy the unnecessary trailing elements
+                destroy_range(new_end, constructed.end());
+
+                return block_view<T>(to_pointer<T>(storage.block().begin()), constructed.size());
+            }
+        } // namespace detail
+
         /// Normalizes a block by moving all constructed objects to the front.
         /// \effects Moves the elements currently constructed at `[constructed.begin(), constructed.end())`
         /// to `[storage.block().begin(), storage.block.begin() + constructed.size())`.
@@ -196,19 +330,8 @@ namespace foonathan
                 return block_view<T>(memory_block(storage.block().begin(), new_end));
             }
             else
-            {
-                // move construct the first offset elements at the correct location
-                auto mid = constructed.begin() + offset / std::ptrdiff_t(sizeof(T));
-                uninitialized_move(constructed.begin(), mid, storage.block());
-
-                // now we can assign the next elements to the already moved ones
-                auto new_end = std::move(mid, constructed.end(), constructed.begin());
-
-                // destroy the unnecessary trailing elements
-                destroy_range(new_end, constructed.end());
-
-                return block_view<T>(to_pointer<T>(storage.block().begin()), constructed.size());
-            }
+                return detail::move_to_front_overlapping(is_trivially_relocatable<T>{}, storage,
+                                                         constructed, offset);
         }
 
         namespace detail
@@ -247,28 +370,40 @@ namespace foonathan
 
                 auto new_size = size_type(std::distance(begin, end)) * sizeof(T);
                 auto cur_size = dest_constructed.size() * sizeof(T);
-                if (new_size <= cur_size)
-                {
-                    auto new_end = copy_or_move_assign(move, begin, end, dest_constructed);
-                    destroy_range(new_end, dest_constructed.end());
-                    return block_view<T>(dest_constructed.begin(), new_end);
-                }
-                else if (new_size <= dest.block().size())
+                try
                 {
-                    auto assign_end = std::next(begin, std::ptrdiff_t(dest_constructed.size()));
-                    copy_or_move_assign(move, begin, assign_end, dest_constructed);
-                    auto new_end =
-                        copy_or_move_construct<T>(move, assign_end, end,
-                                                  memory_block(to_raw_pointer(
-                                                                   dest_constructed.data_end()),
-                                                               dest.block().end()));
-                    return block_view<T>(memory_block(dest.block().begin(), new_end));
+                    if (new_size <= cur_size)
+                    {
+                        auto new_end = copy_or_move_assign(move, begin, end, dest_constructed);
+                        destroy_range(new_end, dest_constructed.end());
+                        return block_view<T>(dest_constructed.begin(), new_end);
+                    }
+                    else if (new_size <= dest.block().size())
+                    {
+                        auto assign_end =
+                            std::next(begin, std::ptrdiff_t(dest_constructed.size()));
+                        copy_or_move_assign(move, begin, assign_end, dest_constructed);
+                        auto new_end = copy_or_move_construct<
+                            T>(move, assign_end, end,
+                               memory_block(to_raw_pointer(dest_constructed.data_end()),
+                                            dest.block().end()));
+                        return block_view<T>(memory_block(dest.block().begin(), new_end));
+                    }
+                    else
+                    {
+                        auto old_constructed = dest_constructed;
+                        dest_constructed     = block_view<T>();
+
+                        auto new_begin = clear_and_reserve(dest, old_constructed, new_size);
+                        auto new_end   = copy_or_move_construct<T>(move, begin, end, dest.block());
+                        return block_view<T>(memory_block(new_begin, new_end));
+                    }
                 }
-                else
+                catch (...)
                 {
-                    auto new_begin = clear_and_reserve(dest, dest_constructed, new_size);
-                    auto new_end   = copy_or_move_construct<T>(move, begin, end, dest.block());
-                    return block_view<T>(memory_block(new_begin, new_end));
+                    // some objects might have been assigned already, so none can be kept
+                    destroy_range(dest_constructed.begin(), dest_constructed.end());
+                    throw;
                 }
             }
         } // namespace detail
@@ -277,6 +412,7 @@ namespace foonathan
         /// then copy constructs or assigns the objects over.
         /// \returns A view to the objects now constructed in `dest`.
         /// \throws Anything thrown by the allocation or copy constructor/assignment of `T`.
+        /// If an exception is thrown, all objects in `dest` have been destroyed.
         /// \requires The constructed objects must start at the beginning of the memory.
         template <class BlockStorage, typename T, typename FwdIter>
         block_view<T> assign_copy(BlockStorage& dest, block_view<T> dest_constructed, FwdIter begin,
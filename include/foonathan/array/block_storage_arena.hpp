@@ -0,0 +1,258 @@
+// Copyright (C) 2018 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#ifndef FOONATHAN_ARRAY_BLOCK_STORAGE_ARENA_HPP_INCLUDED
+#define FOONATHAN_ARRAY_BLOCK_STORAGE_ARENA_HPP_INCLUDED
+
+#include <cstdint>
+#include <new>
+
+#include <foonathan/array/block_storage_heap.hpp>
+
+namespace foonathan
+{
+    namespace array
+    {
+        /// A monotonic memory arena.
+        ///
+        /// It allocates memory by incrementing a pointer in big chunks.
+        /// Memory is only freed in bulk using `rewind()` or `reset()`,
+        /// except for the most recent allocation, which can be rolled back or expanded.
+        class memory_arena
+        {
+            struct chunk
+            {
+                chunk*    prev;
+                size_type size;
+            };
+
+        public:
+            /// The default size of the first chunk.
+            static constexpr size_type default_chunk_size = 4096u;
+
+            /// A position in the arena that can be rewound to.
+            class marker
+            {
+                marker(chunk* c, raw_pointer top) noexcept : chunk_(c), top_(top) {}
+
+                chunk*      chunk_;
+                raw_pointer top_;
+
+                friend memory_arena;
+            };
+
+            //=== constructors/destructors ===//
+            /// \effects Creates an arena without allocating memory.
+            /// Each new chunk is twice as big as the previous one, starting with the given size,
+            /// or one byte if it is zero.
+            explicit memory_arena(size_type initial_chunk_size = default_chunk_size) noexcept
+            : current_(nullptr),
+              top_(nullptr),
+              end_(nullptr),
+              next_chunk_size_(initial_chunk_size == 0u ? 1u : initial_chunk_size)
+            {
+            }
+
+            memory_arena(const memory_arena&) = delete;
+            memory_arena& operator=(const memory_arena&) = delete;
+
+            ~memory_arena() noexcept
+            {
+                free_chunks(nullptr);
+            }
+
+            //=== allocation ===//
+            /// \returns A new memory block of the given size and alignment.
+            /// \throws `std::bad_alloc` if a new chunk couldn't be allocated.
+            memory_block allocate(size_type size, size_type alignment)
+            {
+                // aligning can move the pointer past the end of the chunk
+                auto begin = align(top_, alignment);
+                if (!current_ || size_type(begin - top_) > size_type(end_ - top_)
+                    || size > size_type(end_ - begin))
+                {
+                    allocate_chunk(size + alignment);
+                    begin = align(top_, alignment);
+                }
+
+                top_ = begin + size;
+                return memory_block(begin, size);
+            }
+
+            /// \effects Grows the block in place, if it is the most recent allocation and there is enough space.
+            /// \returns Whether or not it did so.
+            bool try_expand(memory_block& block, size_type new_size) noexcept
+            {
+                if (block.end() != top_ || new_size > size_type(end_ - block.begin()))
+                    return false;
+
+                top_  = block.begin() + new_size;
+                block = memory_block(block.begin(), new_size);
+                return true;
+            }
+
+            /// \effects Rolls back the block, if it is the most recent allocation, does nothing otherwise.
+            void deallocate(const memory_block& block) noexcept
+            {
+                if (block.end() == top_)
+                    top_ = block.begin();
+            }
+
+            //=== rewind/reset ===//
+            /// \returns A marker to the current position.
+            marker top() const noexcept
+            {
+                return marker(current_, top_);
+            }
+
+            /// \effects Frees all memory allocated since the marker was obtained.
+            /// \requires The marker must be obtained from this arena and not already be rewound past.
+            /// All containers using memory allocated after it must have been destroyed.
+            void rewind(const marker& m) noexcept
+            {
+                if (!m.chunk_)
+                    reset();
+                else
+                {
+                    free_chunks(m.chunk_);
+                    top_ = m.top_;
+                    end_ = chunk_memory(current_) + current_->size;
+                }
+            }
+
+            /// \effects Frees all memory allocated by the arena.
+            /// The most recent (and biggest) chunk is kept for future allocations.
+            /// \requires All containers using memory of the arena must have been destroyed.
+            void reset() noexcept
+            {
+                if (!current_)
+                    return;
+
+                // free all but the last chunk
+                auto last = current_;
+                current_  = current_->prev;
+                free_chunks(nullptr);
+
+                last->prev = nullptr;
+                current_   = last;
+                top_       = chunk_memory(current_);
+                end_       = top_ + current_->size;
+            }
+
+        private:
+            static raw_pointer chunk_memory(chunk* c) noexcept
+            {
+                return to_raw_pointer(c) + sizeof(chunk);
+            }
+
+            static raw_pointer align(raw_pointer ptr, size_type alignment) noexcept
+            {
+                auto misaligned = reinterpret_cast<std::uintptr_t>(ptr) & (alignment - 1u);
+                return misaligned == 0u ? ptr : ptr + (alignment - misaligned);
+            }
+
+            void allocate_chunk(size_type min_size)
+            {
+                auto size = next_chunk_size_;
+                while (size < min_size)
+                    size *= 2u;
+
+                auto memory = ::operator new(sizeof(chunk) + size);
+                auto c      = ::new (memory) chunk{current_, size};
+
+                current_         = c;
+                top_             = chunk_memory(c);
+                end_             = top_ + size;
+                next_chunk_size_ = 2u * size;
+            }
+
+            // frees all chunks allocated after the given one
+            void free_chunks(chunk* last) noexcept
+            {
+                while (current_ != last)
+                {
+                    auto prev = current_->prev;
+                    ::operator delete(current_);
+                    current_ = prev;
+                }
+            }
+
+            chunk*      current_;
+            raw_pointer top_;
+            raw_pointer end_;
+            size_type   next_chunk_size_;
+        };
+
+        /// Rewinds a [array::memory_arena]() to the position at construction when it is destroyed.
+        class arena_scope
+        {
+        public:
+            explicit arena_scope(memory_arena& arena) noexcept : arena_(arena), marker_(arena.top())
+            {
+            }
+
+            arena_scope(const arena_scope&) = delete;
+            arena_scope& operator=(const arena_scope&) = delete;
+
+            ~arena_scope() noexcept
+            {
+                arena_.rewind(marker_);
+            }
+
+        private:
+            memory_arena&        arena_;
+            memory_arena::marker marker_;
+        };
+
+        /// A `Heap` that allocates from a [array::memory_arena]().
+        ///
+        /// Deallocation only frees memory of the most recent allocation,
+        /// and it provides `try_expand()`, so growing the most recent container doesn't copy.
+        struct arena_heap
+        {
+            class handle_type
+            {
+            public:
+                explicit handle_type(memory_arena& arena) noexcept : arena_(&arena) {}
+
+                memory_arena& arena() const noexcept
+                {
+                    return *arena_;
+                }
+
+            private:
+                memory_arena* arena_;
+            };
+
+            static memory_block allocate(handle_type& handle, size_type size, size_type alignment)
+            {
+                return handle.arena().allocate(size, alignment);
+            }
+
+            static bool try_expand(handle_type& handle, memory_block& block,
+                                   size_type new_size) noexcept
+            {
+                return handle.arena().try_expand(block, new_size);
+            }
+
+            static void deallocate(handle_type& handle, memory_block&& block) noexcept
+            {
+                handle.arena().deallocate(block);
+            }
+
+            static size_type max_size(const handle_type&) noexcept
+            {
+                return memory_block::max_size();
+            }
+        };
+
+        /// A `BlockStorage` that uses the [array::arena_heap]() for memory allocations.
+        ///
+        /// Pass an [array::arena_heap::handle_type]() using [array::block_storage_arg]() to specify the arena.
+        template <class GrowthPolicy = default_growth>
+        using block_storage_arena = block_storage_heap<arena_heap, GrowthPolicy>;
+    } // namespace array
+} // namespace foonathan
+
+#endif // FOONATHAN_ARRAY_BLOCK_STORAGE_ARENA_HPP_INCLUDED
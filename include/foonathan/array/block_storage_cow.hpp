@@ -0,0 +1,262 @@
+// Copyright (C) 2018 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#ifndef FOONATHAN_ARRAY_BLOCK_STORAGE_COW_HPP_INCLUDED
+#define FOONATHAN_ARRAY_BLOCK_STORAGE_COW_HPP_INCLUDED
+
+#include <atomic>
+#include <cstddef>
+
+#include <foonathan/array/block_storage_heap.hpp>
+#include <foonathan/array/block_storage_new.hpp>
+
+namespace foonathan
+{
+    namespace array
+    {
+        namespace detail
+        {
+            // in front of every block of a block_storage_cow
+            struct alignas(std::max_align_t) cow_header
+            {
+                std::atomic<size_type> references;
+                memory_block           heap_memory;
+            };
+        } // namespace detail
+
+        /// A copy-on-write `BlockStorage` that uses the given `Heap` for (de-)allocation and the given `GrowthPolicy` to control the size.
+        ///
+        /// Copies of a container share the memory and the objects,
+        /// the first modification of a shared container copies the objects into its own memory block.
+        /// The reference count is atomic, so copies can be given to other threads.
+        /// Containers detect it using [array::block_storage_copy_on_write]().
+        /// \requires `alignof(T)` must not be bigger than `alignof(std::max_align_t)`.
+        template <class Heap = new_heap, class GrowthPolicy = default_growth>
+        class block_storage_cow
+        : block_storage_args_storage<block_storage_args_t<typename Heap::handle_type>>
+        {
+        public:
+            using embedded_storage = std::false_type;
+            using arg_type         = block_storage_args_t<typename Heap::handle_type>;
+            using copy_on_write    = std::true_type;
+
+            //=== constructors/destructors ===//
+            explicit block_storage_cow(const arg_type& arg) noexcept
+            : block_storage_args_storage<arg_type>(arg), begin_(nullptr), size_(0u)
+            {
+            }
+
+            ~block_storage_cow() noexcept
+            {
+                // the objects have been destroyed already, if they aren't shared
+                if (begin_ && header().references.fetch_sub(1u, std::memory_order_acq_rel) == 1u)
+                    deallocate();
+            }
+
+            block_storage_cow(const block_storage_cow&) = delete;
+            block_storage_cow& operator=(const block_storage_cow&) = delete;
+
+            template <typename T>
+            static void swap(block_storage_cow& lhs, block_view<T>& lhs_constructed,
+                             block_storage_cow& rhs, block_view<T>& rhs_constructed) noexcept
+            {
+                std::swap(static_cast<block_storage_args_storage<arg_type>&>(lhs),
+                          static_cast<block_storage_args_storage<arg_type>&>(rhs));
+                std::swap(lhs.begin_, rhs.begin_);
+                std::swap(lhs.size_, rhs.size_);
+                std::swap(lhs_constructed, rhs_constructed);
+            }
+
+            //=== reserve/shrink_to_fit ===//
+            /// \requires The memory must not be shared.
+            template <typename T>
+            raw_pointer reserve(size_type min_additional_bytes, const block_view<T>& constructed)
+            {
+                assert(!is_shared());
+                auto new_size =
+                    GrowthPolicy::growth_size(size_, min_additional_bytes, max_size(arguments()));
+                return change_block(constructed, new_size);
+            }
+
+            /// \requires The memory must not be shared.
+            template <typename T>
+            raw_pointer shrink_to_fit(const block_view<T>& constructed)
+            {
+                assert(!is_shared());
+                auto byte_size = constructed.size() * sizeof(T);
+                if (byte_size == 0u)
+                {
+                    release(constructed);
+                    return begin_;
+                }
+
+                auto new_size = GrowthPolicy::shrink_size(size_, byte_size, max_size(arguments()));
+                if (new_size >= size_)
+                    return to_raw_pointer(move_to_front(*this, constructed).data_end());
+                else
+                    return change_block(constructed, new_size);
+            }
+
+            //=== copy-on-write ===//
+            /// \returns Whether or not the memory block is shared with another storage.
+            bool is_shared() const noexcept
+            {
+                return begin_ && header().references.load(std::memory_order_acquire) > 1u;
+            }
+
+            /// \effects Shares the memory block and the objects of the other storage.
+            /// \returns A pointer directly after the last constructed object.
+            /// \requires The storage must not own memory yet.
+            template <typename T>
+            raw_pointer share(const block_storage_cow& other,
+                              const block_view<T>&     other_constructed) noexcept
+            {
+                assert(!begin_);
+                if (other.begin_)
+                {
+                    other.header().references.fetch_add(1u, std::memory_order_relaxed);
+                    begin_ = other.begin_;
+                    size_  = other.size_;
+                }
+                return to_raw_pointer(other_constructed.data_end());
+            }
+
+            /// \effects If the memory block is shared, copies the objects into a new memory block of the same size.
+            /// \returns A pointer directly after the last constructed object in the new location.
+            /// \throws Anything thrown by the allocation function or the copy constructor of `T`.
+            /// If an exception is thrown, nothing has changed.
+            template <typename T>
+            raw_pointer unshare(const block_view<T>& constructed)
+            {
+                if (!is_shared())
+                    return to_raw_pointer(constructed.data_end());
+                else if (constructed.empty())
+                {
+                    release(constructed);
+                    return begin_;
+                }
+
+                auto new_block = allocate(size_);
+                auto new_end   = new_block.begin();
+                try
+                {
+                    new_end = uninitialized_copy(constructed.begin(), constructed.end(), new_block);
+                }
+                catch (...)
+                {
+                    deallocate(new_block);
+                    throw;
+                }
+
+                // might destroy the old objects, if the others have released them in the mean time
+                release(constructed);
+                begin_ = new_block.begin();
+                size_  = new_block.size();
+                return new_end;
+            }
+
+            /// \effects Gives up ownership of the memory block,
+            /// destroys the objects and deallocates it if it wasn't shared.
+            template <typename T>
+            void release(const block_view<T>& constructed) noexcept
+            {
+                if (!begin_)
+                    return;
+                else if (header().references.fetch_sub(1u, std::memory_order_acq_rel) == 1u)
+                {
+                    destroy_range(constructed.begin(), constructed.end());
+                    deallocate();
+                }
+
+                begin_ = nullptr;
+                size_  = 0u;
+            }
+
+            //=== accessors ===//
+            memory_block empty_block() const noexcept
+            {
+                return memory_block();
+            }
+
+            memory_block block() const noexcept
+            {
+                return memory_block(begin_, size_);
+            }
+
+            auto arguments() const noexcept -> decltype(this->stored_arguments())
+            {
+                return this->stored_arguments();
+            }
+
+            static size_type max_size(const arg_type& args) noexcept
+            {
+                auto&& handle = std::get<0>(args.args);
+                return Heap::max_size(handle) - sizeof(detail::cow_header);
+            }
+
+        private:
+            detail::cow_header& header() const noexcept
+            {
+                return *reinterpret_cast<detail::cow_header*>(begin_ - sizeof(detail::cow_header));
+            }
+
+            // allocates a new block with a reference count of one
+            memory_block allocate(size_type size)
+            {
+                auto&& handle      = std::get<0>(this->stored_arguments().args);
+                auto   heap_memory = Heap::allocate(handle, sizeof(detail::cow_header) + size,
+                                                  detail::max_heap_alignment);
+
+                auto header = ::new (to_void_pointer(heap_memory.begin()))
+                    detail::cow_header{{1u}, heap_memory};
+                return memory_block(to_raw_pointer(header + 1),
+                                    heap_memory.size() - sizeof(detail::cow_header));
+            }
+
+            void deallocate(const memory_block& block) noexcept
+            {
+                auto&& handle      = std::get<0>(this->stored_arguments().args);
+                auto&  header      = reinterpret_cast<detail::cow_header*>(block.begin())[-1];
+                auto   heap_memory = header.heap_memory;
+                header.~cow_header();
+                Heap::deallocate(handle, std::move(heap_memory));
+            }
+            void deallocate() noexcept
+            {
+                deallocate(block());
+            }
+
+            template <typename T>
+            raw_pointer change_block(const block_view<T>& constructed, size_type new_size)
+            {
+                static_assert(alignof(T) <= detail::max_heap_alignment,
+                              "over-aligned types are not supported");
+
+                auto new_block = allocate(new_size);
+                auto new_end   = new_block.begin();
+                try
+                {
+                    new_end = uninitialized_destructive_move(constructed.begin(), constructed.end(),
+                                                             new_block);
+                }
+                catch (...)
+                {
+                    deallocate(new_block);
+                    throw;
+                }
+
+                if (begin_)
+                    deallocate();
+                begin_ = new_block.begin();
+                size_  = new_block.size();
+                return new_end;
+            }
+
+            raw_pointer begin_;
+            size_type   size_;
+        };
+    } // namespace array
+} // namespace foonathan
+
+#endif // FOONATHAN_ARRAY_BLOCK_STORAGE_COW_HPP_INCLUDED
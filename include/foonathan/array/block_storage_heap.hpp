@@ -5,6 +5,10 @@
 #ifndef FOONATHAN_ARRAY_BLOCK_STORAGE_HEAP_HPP_INCLUDED
 #define FOONATHAN_ARRAY_BLOCK_STORAGE_HEAP_HPP_INCLUDED
 
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <utility>
 
 #include <foonathan/array/block_storage.hpp>
@@ -14,9 +18,170 @@ namespace foonathan
 {
     namespace array
     {
+        namespace detail
+        {
+            template <class Heap, typename = void>
+            struct heap_has_try_expand : std::false_type
+            {
+            };
+
+            template <class Heap>
+            struct heap_has_try_expand<Heap, decltype(void(Heap::try_expand(
+                                                 std::declval<typename Heap::handle_type&>(),
+                                                 std::declval<memory_block&>(), size_type(0))))>
+            : std::true_type
+            {
+            };
+
+            template <class Heap, typename = void>
+            struct heap_has_reallocate : std::false_type
+            {
+            };
+
+            template <class Heap>
+            struct heap_has_reallocate<Heap, decltype(void(Heap::reallocate(
+                                                 std::declval<typename Heap::handle_type&>(),
+                                                 std::declval<memory_block>(), size_type(0),
+                                                 size_type(0))))> : std::true_type
+            {
+            };
+
+            template <class Heap, typename = void>
+            struct heap_has_allocate_zeroed : std::false_type
+            {
+            };
+
+            template <class Heap>
+            struct heap_has_allocate_zeroed<
+                Heap,
+                decltype(void(Heap::allocate_zeroed(std::declval<typename Heap::handle_type&>(),
+                                                    size_type(0), size_type(0))))> : std::true_type
+            {
+            };
+
+            template <class Heap, typename = void>
+            struct heap_has_good_size : std::false_type
+            {
+            };
+
+            template <class Heap>
+            struct heap_has_good_size<Heap, decltype(void(Heap::good_size(
+                                                std::declval<const typename Heap::handle_type&>(),
+                                                size_type(0))))> : std::true_type
+            {
+            };
+
+            // reallocate() copies the bytes, so only valid for trivially relocatable types
+            template <class Heap, typename T>
+            struct heap_can_reallocate
+            : std::integral_constant<bool, heap_has_reallocate<Heap>::value
+                                               && is_trivially_relocatable<T>::value>
+            {
+            };
+
+            // the biggest alignment every heap has to support
+            constexpr size_type max_heap_alignment = alignof(std::max_align_t);
+
+            // the memory block of a block_storage_heap
+            // over-aligned blocks are allocated with some extra memory in front,
+            // it contains the block actually allocated by the heap,
+            // which is marked by the highest bit of the size
+            class heap_block
+            {
+                static constexpr size_type header_flag = size_type(1)
+                                                         << (sizeof(size_type) * CHAR_BIT - 1);
+
+            public:
+                static constexpr size_type max_size() noexcept
+                {
+                    return header_flag - 1u;
+                }
+
+                heap_block() noexcept : begin_(nullptr), size_(0u) {}
+
+                explicit heap_block(const memory_block& block, bool has_header = false) noexcept
+                : begin_(block.begin()), size_(has_header ? block.size() | header_flag : block.size())
+                {
+                }
+
+                memory_block block() const noexcept
+                {
+                    return memory_block(begin_, size());
+                }
+
+                bool empty() const noexcept
+                {
+                    return size() == 0u;
+                }
+
+                size_type size() const noexcept
+                {
+                    return size_ & ~header_flag;
+                }
+
+                raw_pointer begin() const noexcept
+                {
+                    return begin_;
+                }
+
+                bool has_header() const noexcept
+                {
+                    return (size_ & header_flag) != 0u;
+                }
+
+                // the block that needs to be passed to the heap
+                memory_block heap_memory() const noexcept
+                {
+                    if (!has_header())
+                        return block();
+
+                    memory_block result;
+                    std::memcpy(&result, begin_ - sizeof(memory_block), sizeof(memory_block));
+                    return result;
+                }
+
+                // over-allocated size required for the given alignment
+                static size_type header_size(size_type alignment) noexcept
+                {
+                    return sizeof(memory_block) + alignment - 1u;
+                }
+
+                static heap_block with_header(const memory_block& heap_memory, size_type size,
+                                              size_type alignment) noexcept
+                {
+                    auto address = reinterpret_cast<std::uintptr_t>(
+                        heap_memory.begin() + sizeof(memory_block));
+                    auto misaligned = address & (alignment - 1u);
+                    auto begin      = heap_memory.begin() + sizeof(memory_block)
+                                 + (misaligned == 0u ? 0u : alignment - misaligned);
+
+                    std::memcpy(begin - sizeof(memory_block), &heap_memory, sizeof(memory_block));
+                    return heap_block(memory_block(begin, size), true);
+                }
+
+            private:
+                raw_pointer begin_;
+                size_type   size_;
+            };
+        } // namespace detail
+
         /// A `BlockStorage` that uses the given `Heap` for (de-)allocation and the given `GrowthPolicy` to control the size.
         ///
         /// It does not have a small buffer optimization.
+        ///
+        /// If the `Heap` provides the optional `try_expand()` function,
+        /// it will first try to grow the block in place.
+        /// If it provides the optional `reallocate()` function,
+        /// it will be used to resize blocks of trivially relocatable types.
+        /// It provides `reserve_with_gap()`, so containers can insert in the middle without moving objects twice.
+        /// If it provides the optional `good_size()` function,
+        /// the size requested by the `GrowthPolicy` is rounded up to it.
+        /// If it provides the optional `allocate_zeroed()` function,
+        /// the storage provides `reserve_zeroed()`, which containers use for value initialized elements.
+        /// Containers shrink automatically if the `GrowthPolicy` is an [array::auto_shrink_growth]().
+        ///
+        /// The `Heap` only needs to support alignments up to `alignof(std::max_align_t)`,
+        /// memory for over-aligned types is over-allocated and aligned manually.
         template <class Heap, class GrowthPolicy>
         class block_storage_heap
         : block_storage_args_storage<block_storage_args_t<typename Heap::handle_type>>
@@ -24,6 +189,7 @@ namespace foonathan
         public:
             using embedded_storage = std::false_type;
             using arg_type         = block_storage_args_t<typename Heap::handle_type>;
+            using auto_shrink      = detail::growth_auto_shrink<GrowthPolicy>;
 
             //=== constructors/destructors ===//
             explicit block_storage_heap(const arg_type& arg) noexcept
@@ -33,7 +199,7 @@ namespace foonathan
 
             ~block_storage_heap() noexcept
             {
-                deallocate_block(std::move(block_));
+                deallocate_block(block_);
             }
 
             block_storage_heap(const block_storage_heap&) = delete;
@@ -53,19 +219,74 @@ namespace foonathan
             template <typename T>
             raw_pointer reserve(size_type min_additional_bytes, const block_view<T>& constructed)
             {
-                auto new_size  = GrowthPolicy::growth_size(block_.size(), min_additional_bytes,
+                auto new_size = GrowthPolicy::growth_size(block_.size(), min_additional_bytes,
+                                                          max_size(arguments()));
+                return resize_block(constructed,
+                                    good_size(detail::heap_has_good_size<Heap>{}, new_size));
+            }
+
+            /// \effects Same as `reserve()`, but the new memory block is zeroed after the constructed objects.
+            /// \notes It always allocates a new memory block using `allocate_zeroed()`.
+            template <typename T, class H = Heap,
+                      typename = typename std::enable_if<
+                          detail::heap_has_allocate_zeroed<H>::value>::type>
+            raw_pointer reserve_zeroed(size_type           min_additional_bytes,
+                                       const block_view<T>& constructed)
+            {
+                auto new_size = GrowthPolicy::growth_size(block_.size(), min_additional_bytes,
                                                           max_size(arguments()));
+                new_size      = good_size(detail::heap_has_good_size<Heap>{}, new_size);
+                return change_block(constructed,
+                                    allocate_block(new_size, alignof(T), std::true_type{}));
+            }
+
+            /// \effects Same as `reserve(gap_bytes, constructed)`,
+            /// but leaves `gap_bytes` uninitialized bytes before the object at index `position`.
+            /// \returns A pointer directly after the last constructed object, including the gap.
+            template <typename T>
+            raw_pointer reserve_with_gap(size_type position, size_type gap_bytes,
+                                         const block_view<T>& constructed)
+            {
+                auto new_size = GrowthPolicy::growth_size(block_.size(), gap_bytes,
+                                                          max_size(arguments()));
+                new_size      = good_size(detail::heap_has_good_size<Heap>{}, new_size);
+                if (expand_with_gap(is_trivially_relocatable<T>{}, position, gap_bytes, constructed,
+                                    new_size))
+                    return to_raw_pointer(constructed.data_end()) + gap_bytes;
+
                 auto new_block = allocate_block(new_size, alignof(T));
-                return change_block(constructed, std::move(new_block));
+                raw_pointer end;
+                try
+                {
+                    end = uninitialized_destructive_move_with_gap(constructed.begin(),
+                                                                  constructed.begin() + position,
+                                                                  constructed.end(), gap_bytes,
+                                                                  new_block.block());
+                }
+                catch (...)
+                {
+                    deallocate_block(new_block);
+                    throw;
+                }
+
+                deallocate_block(block_);
+                block_ = new_block;
+
+                return end;
             }
 
             template <typename T>
             raw_pointer shrink_to_fit(const block_view<T>& constructed)
             {
                 auto byte_size = constructed.size() * sizeof(T);
-                auto new_size  = GrowthPolicy::shrink_size(block_.size(), byte_size);
-                auto new_block = allocate_block(new_size, alignof(T));
-                return change_block(constructed, std::move(new_block));
+                auto new_size  = good_size(detail::heap_has_good_size<Heap>{},
+                                          GrowthPolicy::shrink_size(block_.size(), byte_size,
+                                                                    max_size(arguments())));
+                if (new_size >= block_.size()
+                    && constructed.data() == to_pointer<T>(block_.begin()))
+                    // nothing to do
+                    return to_raw_pointer(constructed.data_end());
+                return resize_block(constructed, new_size);
             }
 
             //=== accessors ===//
@@ -74,9 +295,9 @@ namespace foonathan
                 return {};
             }
 
-            const memory_block& block() const noexcept
+            memory_block block() const noexcept
             {
-                return block_;
+                return block_.block();
             }
 
             auto arguments() const noexcept -> decltype(this->stored_arguments())
@@ -87,50 +308,159 @@ namespace foonathan
             static size_type max_size(const arg_type& args) noexcept
             {
                 auto&& handle = std::get<0>(args.args);
-                return Heap::max_size(handle);
+                auto   max    = Heap::max_size(handle);
+                return max < detail::heap_block::max_size() ? max : detail::heap_block::max_size();
             }
 
         private:
-            void deallocate_block(memory_block&& block) noexcept
+            void deallocate_block(const detail::heap_block& block) noexcept
             {
                 auto&& handle = std::get<0>(this->stored_arguments().args);
                 if (!block.empty())
-                    Heap::deallocate(handle, std::move(block));
+                    Heap::deallocate(handle, block.heap_memory());
+            }
+
+            detail::heap_block allocate_block(size_type size, size_type alignment)
+            {
+                return allocate_block(size, alignment, std::false_type{});
             }
 
-            memory_block allocate_block(size_type size, size_type alignment)
+            template <class Zeroed>
+            detail::heap_block allocate_block(size_type size, size_type alignment, Zeroed zeroed)
             {
                 if (size == 0)
-                    return memory_block();
+                    return detail::heap_block();
+                else if (alignment <= detail::max_heap_alignment)
+                    return detail::heap_block(allocate_heap(zeroed, size, alignment));
                 else
                 {
-                    auto&& handle = std::get<0>(this->stored_arguments().args);
-                    return Heap::allocate(handle, size, alignment);
+                    auto heap_memory =
+                        allocate_heap(zeroed, size + detail::heap_block::header_size(alignment),
+                                      detail::max_heap_alignment);
+                    return detail::heap_block::with_header(heap_memory, size, alignment);
                 }
             }
 
+            memory_block allocate_heap(std::false_type, size_type size, size_type alignment)
+            {
+                auto&& handle = std::get<0>(this->stored_arguments().args);
+                return Heap::allocate(handle, size, alignment);
+            }
+            memory_block allocate_heap(std::true_type, size_type size, size_type alignment)
+            {
+                auto&& handle = std::get<0>(this->stored_arguments().args);
+                return Heap::allocate_zeroed(handle, size, alignment);
+            }
+
+            size_type good_size(std::true_type, size_type size) const noexcept
+            {
+                if (size == 0u)
+                    return 0u;
+
+                auto&& handle = std::get<0>(this->stored_arguments().args);
+                auto   result = Heap::good_size(handle, size);
+                return result < max_size(arguments()) ? result : max_size(arguments());
+            }
+            size_type good_size(std::false_type, size_type size) const noexcept
+            {
+                return size;
+            }
+
+            bool try_expand_block(std::true_type, size_type new_size) noexcept
+            {
+                auto&& handle = std::get<0>(this->stored_arguments().args);
+                auto   block  = block_.block();
+                if (!Heap::try_expand(handle, block, new_size))
+                    return false;
+                block_ = detail::heap_block(block);
+                return true;
+            }
+            bool try_expand_block(std::false_type, size_type) noexcept
+            {
+                return false;
+            }
+
+            // grows the block in place and moves the objects after the gap, if possible
+            template <typename T>
+            bool expand_with_gap(std::true_type, size_type position, size_type gap_bytes,
+                                 const block_view<T>& constructed, size_type new_size) noexcept
+            {
+                if (block_.empty() || block_.has_header()
+                    || constructed.data() != to_pointer<T>(block_.begin())
+                    || !try_expand_block(detail::heap_has_try_expand<Heap>{}, new_size))
+                    return false;
+
+                auto gap = constructed.data() + position;
+                detail::relocate_overlapping(gap, constructed.data_end(), gap + gap_bytes / sizeof(T));
+                return true;
+            }
+            template <typename T>
+            bool expand_with_gap(std::false_type, size_type, size_type, const block_view<T>&,
+                                 size_type) noexcept
+            {
+                return false;
+            }
+
+            template <typename T>
+            raw_pointer reallocate_block(std::true_type, const block_view<T>& constructed,
+                                         size_type new_size)
+            {
+                auto&& handle = std::get<0>(this->stored_arguments().args);
+                auto   offset = constructed.size() * sizeof(T);
+                // if it throws, the block is unchanged
+                block_ = detail::heap_block(
+                    Heap::reallocate(handle, block_.block(), new_size, alignof(T)));
+                return block_.begin() + offset;
+            }
+            template <typename T>
+            raw_pointer reallocate_block(std::false_type, const block_view<T>& constructed,
+                                         size_type new_size)
+            {
+                return change_block(constructed, allocate_block(new_size, alignof(T)));
+            }
+
+            template <typename T>
+            raw_pointer resize_block(const block_view<T>& constructed, size_type new_size)
+            {
+                if (!block_.empty() && !block_.has_header() && new_size != 0u
+                    && constructed.data() == to_pointer<T>(block_.begin()))
+                {
+                    // the objects are already at the front of the block,
+                    // so we can keep them where they are if the heap supports it
+                    if (new_size > block_.size()
+                        && try_expand_block(detail::heap_has_try_expand<Heap>{}, new_size))
+                        return to_raw_pointer(constructed.data_end());
+                    else if (!constructed.empty())
+                        return reallocate_block(detail::heap_can_reallocate<Heap, T>{},
+                                                constructed, new_size);
+                }
+
+                return change_block(constructed, allocate_block(new_size, alignof(T)));
+            }
+
             template <typename T>
-            raw_pointer change_block(const block_view<T>& constructed, memory_block&& new_block)
+            raw_pointer change_block(const block_view<T>& constructed,
+                                     const detail::heap_block& new_block)
             {
                 raw_pointer end;
                 try
                 {
                     end = uninitialized_destructive_move(constructed.begin(), constructed.end(),
-                                                         new_block);
+                                                         new_block.block());
                 }
                 catch (...)
                 {
-                    deallocate_block(std::move(new_block));
+                    deallocate_block(new_block);
                     throw;
                 }
 
-                deallocate_block(std::move(block_));
+                deallocate_block(block_);
                 block_ = new_block;
 
                 return end;
             }
 
-            memory_block block_;
+            detail::heap_block block_;
         };
     } // namespace array
 } // namespace foonathan
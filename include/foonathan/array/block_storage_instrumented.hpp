@@ -0,0 +1,445 @@
+// Copyright (C) 2018 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#ifndef FOONATHAN_ARRAY_BLOCK_STORAGE_INSTRUMENTED_HPP_INCLUDED
+#define FOONATHAN_ARRAY_BLOCK_STORAGE_INSTRUMENTED_HPP_INCLUDED
+
+#include <atomic>
+
+#include <foonathan/array/block_storage.hpp>
+
+namespace foonathan
+{
+    namespace array
+    {
+        namespace detail
+        {
+            template <class Tag, typename = void>
+            struct statistics_name
+            {
+                static const char* get() noexcept
+                {
+                    return nullptr;
+                }
+            };
+
+            template <class Tag>
+            struct statistics_name<Tag, decltype(void(Tag::name()))>
+            {
+                static const char* get() noexcept
+                {
+                    return Tag::name();
+                }
+            };
+        } // namespace detail
+
+        /// The allocation statistics of all [array::block_storage_instrumented]() objects with the same tag.
+        ///
+        /// All counters are updated atomically, so the statistics can be queried while containers are in use.
+        class storage_statistics
+        {
+        public:
+            /// \returns The statistics of the given tag.
+            /// If the tag has a static member function `name()`, it is used as the name of the statistics.
+            template <class Tag>
+            static storage_statistics& of() noexcept
+            {
+                static storage_statistics statistics(detail::statistics_name<Tag>::get());
+                return statistics;
+            }
+
+            /// \effects Invokes the function with each [array::storage_statistics]() that has been used so far.
+            template <typename Func>
+            static void for_each(Func f)
+            {
+                for (auto cur = registry().load(std::memory_order_acquire); cur; cur = cur->next_)
+                    f(static_cast<const storage_statistics&>(*cur));
+            }
+
+            storage_statistics(const storage_statistics&) = delete;
+            storage_statistics& operator=(const storage_statistics&) = delete;
+
+            /// \returns The name of the tag, or `nullptr` if it doesn't have one.
+            const char* name() const noexcept
+            {
+                return name_;
+            }
+
+            /// \returns The number of memory blocks that have been allocated.
+            size_type allocations() const noexcept
+            {
+                return allocations_.load(std::memory_order_relaxed);
+            }
+
+            /// \returns The number of memory blocks that have been grown in place.
+            size_type expansions() const noexcept
+            {
+                return expansions_.load(std::memory_order_relaxed);
+            }
+
+            /// \returns The number of memory blocks that have been released.
+            size_type deallocations() const noexcept
+            {
+                return deallocations_.load(std::memory_order_relaxed);
+            }
+
+            /// \returns The total number of bytes allocated, including in place growth.
+            size_type bytes_allocated() const noexcept
+            {
+                return bytes_allocated_.load(std::memory_order_relaxed);
+            }
+
+            /// \returns The total number of bytes of objects that have been moved to a different memory block,
+            /// either due to a reallocation or a transfer between embedded and dynamic storage.
+            size_type bytes_relocated() const noexcept
+            {
+                return bytes_relocated_.load(std::memory_order_relaxed);
+            }
+
+            /// \returns The total number of bytes new or resized memory blocks were bigger than requested,
+            /// i.e. the extra memory due to the growth policy and rounding of the heap.
+            size_type bytes_wasted() const noexcept
+            {
+                return bytes_wasted_.load(std::memory_order_relaxed);
+            }
+
+            /// \returns The number of bytes of all currently allocated memory blocks.
+            size_type capacity() const noexcept
+            {
+                return capacity_.load(std::memory_order_relaxed);
+            }
+
+            /// \returns The highest value [*capacity]() ever had.
+            size_type peak_capacity() const noexcept
+            {
+                return peak_capacity_.load(std::memory_order_relaxed);
+            }
+
+            /// \effects Resets all counters except the current capacity.
+            void reset() noexcept
+            {
+                allocations_.store(0u, std::memory_order_relaxed);
+                expansions_.store(0u, std::memory_order_relaxed);
+                deallocations_.store(0u, std::memory_order_relaxed);
+                bytes_allocated_.store(0u, std::memory_order_relaxed);
+                bytes_relocated_.store(0u, std::memory_order_relaxed);
+                bytes_wasted_.store(0u, std::memory_order_relaxed);
+                peak_capacity_.store(capacity(), std::memory_order_relaxed);
+            }
+
+        private:
+            explicit storage_statistics(const char* name) noexcept
+            : name_(name),
+              allocations_(0u),
+              expansions_(0u),
+              deallocations_(0u),
+              bytes_allocated_(0u),
+              bytes_relocated_(0u),
+              bytes_wasted_(0u),
+              capacity_(0u),
+              peak_capacity_(0u),
+              next_(registry().load(std::memory_order_relaxed))
+            {
+                while (!registry().compare_exchange_weak(next_, this, std::memory_order_release,
+                                                         std::memory_order_relaxed))
+                {
+                }
+            }
+
+            static std::atomic<storage_statistics*>& registry() noexcept
+            {
+                static std::atomic<storage_statistics*> head(nullptr);
+                return head;
+            }
+
+            // called after an operation that might have changed the memory block of a storage
+            void on_change(bool old_allocated, const memory_block& old_block, bool new_allocated,
+                           const memory_block& new_block, size_type requested,
+                           size_type relocated) noexcept
+            {
+                if (old_block.begin() == new_block.begin() && old_block.size() == new_block.size())
+                    return;
+
+                auto old_size = old_allocated ? old_block.size() : 0u;
+                auto new_size = new_allocated ? new_block.size() : 0u;
+
+                if (old_block.begin() != new_block.begin())
+                {
+                    if (new_allocated)
+                    {
+                        allocations_.fetch_add(1u, std::memory_order_relaxed);
+                        bytes_allocated_.fetch_add(new_size, std::memory_order_relaxed);
+                    }
+                    if (old_allocated)
+                        deallocations_.fetch_add(1u, std::memory_order_relaxed);
+                    bytes_relocated_.fetch_add(relocated, std::memory_order_relaxed);
+                }
+                else if (new_size > old_size)
+                {
+                    expansions_.fetch_add(1u, std::memory_order_relaxed);
+                    bytes_allocated_.fetch_add(new_size - old_size, std::memory_order_relaxed);
+                }
+
+                if (new_size > requested)
+                    bytes_wasted_.fetch_add(new_size - requested, std::memory_order_relaxed);
+
+                if (new_size >= old_size)
+                    add_capacity(new_size - old_size);
+                else
+                    capacity_.fetch_sub(old_size - new_size, std::memory_order_relaxed);
+            }
+
+            void on_create(size_type size) noexcept
+            {
+                add_capacity(size);
+            }
+
+            void on_destroy(size_type size) noexcept
+            {
+                deallocations_.fetch_add(1u, std::memory_order_relaxed);
+                capacity_.fetch_sub(size, std::memory_order_relaxed);
+            }
+
+            void on_relocate(size_type relocated) noexcept
+            {
+                bytes_relocated_.fetch_add(relocated, std::memory_order_relaxed);
+            }
+
+            // a shared memory block is part of the capacity of each storage, but not allocated
+            void on_share(size_type size) noexcept
+            {
+                add_capacity(size);
+            }
+
+            void on_release_shared(size_type size) noexcept
+            {
+                capacity_.fetch_sub(size, std::memory_order_relaxed);
+            }
+
+            void add_capacity(size_type size) noexcept
+            {
+                auto new_capacity = capacity_.fetch_add(size, std::memory_order_relaxed) + size;
+                auto peak         = peak_capacity_.load(std::memory_order_relaxed);
+                while (peak < new_capacity
+                       && !peak_capacity_.compare_exchange_weak(peak, new_capacity,
+                                                                std::memory_order_relaxed))
+                {
+                }
+            }
+
+            const char*            name_;
+            std::atomic<size_type> allocations_;
+            std::atomic<size_type> expansions_;
+            std::atomic<size_type> deallocations_;
+            std::atomic<size_type> bytes_allocated_;
+            std::atomic<size_type> bytes_relocated_;
+            std::atomic<size_type> bytes_wasted_;
+            std::atomic<size_type> capacity_;
+            std::atomic<size_type> peak_capacity_;
+            storage_statistics*    next_;
+
+            template <class BlockStorage, class Tag>
+            friend class block_storage_instrumented;
+        };
+
+        /// A `BlockStorage` that forwards to another `BlockStorage` and records its allocations.
+        ///
+        /// All storages with the same `Tag` share one [array::storage_statistics](),
+        /// use a distinct tag for each container you want to observe.
+        /// A memory block counts as allocated if it is not the `empty_block()`,
+        /// so the buffer of an embedded storage is not counted, but transfers out of it are.
+        /// The optional `reserve_zeroed()`, `reserve_with_gap()` and copy-on-write functions
+        /// are forwarded if the `BlockStorage` provides them,
+        /// so it behaves exactly like the wrapped storage.
+        template <class BlockStorage, class Tag = BlockStorage>
+        class block_storage_instrumented
+        {
+        public:
+            using embedded_storage = typename BlockStorage::embedded_storage;
+            using arg_type         = typename BlockStorage::arg_type;
+            using auto_shrink      = block_storage_auto_shrink<BlockStorage>;
+            using copy_on_write    = block_storage_copy_on_write<BlockStorage>;
+
+            /// \returns The statistics of the tag.
+            static storage_statistics& statistics() noexcept
+            {
+                return storage_statistics::of<Tag>();
+            }
+
+            //=== constructors/destructors ===//
+            explicit block_storage_instrumented(arg_type args) noexcept : storage_(std::move(args))
+            {
+                if (is_allocated())
+                    statistics().on_create(storage_.block().size());
+            }
+
+            ~block_storage_instrumented() noexcept
+            {
+                if (is_allocated())
+                    statistics().on_destroy(storage_.block().size());
+            }
+
+            block_storage_instrumented(const block_storage_instrumented&) = delete;
+            block_storage_instrumented& operator=(const block_storage_instrumented&) = delete;
+
+            template <typename T>
+            static void swap(block_storage_instrumented& lhs, block_view<T>& lhs_constructed,
+                             block_storage_instrumented& rhs,
+                             block_view<T>& rhs_constructed) noexcept(noexcept(
+                BlockStorage::swap(lhs.storage_, lhs_constructed, rhs.storage_, rhs_constructed)))
+            {
+                auto lhs_old = lhs_constructed;
+                auto rhs_old = rhs_constructed;
+                BlockStorage::swap(lhs.storage_, lhs_constructed, rhs.storage_, rhs_constructed);
+
+                // both have the same tag, so only relocation changes the statistics
+                if (lhs_constructed.data() != rhs_old.data())
+                    statistics().on_relocate(rhs_old.size() * sizeof(T));
+                if (rhs_constructed.data() != lhs_old.data())
+                    statistics().on_relocate(lhs_old.size() * sizeof(T));
+            }
+
+            //=== reserve/shrink_to_fit ===//
+            template <typename T>
+            raw_pointer reserve(size_type min_additional_bytes, const block_view<T>& constructed)
+            {
+                auto old_block     = storage_.block();
+                auto old_allocated = is_allocated();
+
+                auto result = storage_.reserve(min_additional_bytes, constructed);
+                statistics().on_change(old_allocated, old_block, is_allocated(), storage_.block(),
+                                       old_block.size() + min_additional_bytes,
+                                       constructed.size() * sizeof(T));
+                return result;
+            }
+
+            template <typename T, class S = BlockStorage>
+            auto reserve_zeroed(size_type min_additional_bytes, const block_view<T>& constructed)
+                -> decltype(std::declval<S&>().reserve_zeroed(min_additional_bytes, constructed))
+            {
+                auto old_block     = storage_.block();
+                auto old_allocated = is_allocated();
+
+                auto result = storage_.reserve_zeroed(min_additional_bytes, constructed);
+                statistics().on_change(old_allocated, old_block, is_allocated(), storage_.block(),
+                                       old_block.size() + min_additional_bytes,
+                                       constructed.size() * sizeof(T));
+                return result;
+            }
+
+            template <typename T, class S = BlockStorage>
+            auto reserve_with_gap(size_type position, size_type gap_bytes,
+                                  const block_view<T>& constructed)
+                -> decltype(std::declval<S&>().reserve_with_gap(position, gap_bytes, constructed))
+            {
+                auto old_block     = storage_.block();
+                auto old_allocated = is_allocated();
+
+                auto result = storage_.reserve_with_gap(position, gap_bytes, constructed);
+                statistics().on_change(old_allocated, old_block, is_allocated(), storage_.block(),
+                                       old_block.size() + gap_bytes,
+                                       constructed.size() * sizeof(T));
+                return result;
+            }
+
+            template <typename T>
+            raw_pointer shrink_to_fit(const block_view<T>& constructed)
+            {
+                auto old_block     = storage_.block();
+                auto old_allocated = is_allocated();
+
+                auto result = storage_.shrink_to_fit(constructed);
+                statistics().on_change(old_allocated, old_block, is_allocated(), storage_.block(),
+                                       constructed.size() * sizeof(T),
+                                       constructed.size() * sizeof(T));
+                return result;
+            }
+
+            //=== copy-on-write ===//
+            template <class S = BlockStorage>
+            auto is_shared() const noexcept -> decltype(std::declval<const S&>().is_shared())
+            {
+                return storage_.is_shared();
+            }
+
+            template <typename T, class S = BlockStorage>
+            auto share(const block_storage_instrumented& other,
+                       const block_view<T>&              other_constructed) noexcept
+                -> decltype(std::declval<S&>().share(std::declval<const S&>(), other_constructed))
+            {
+                auto result = storage_.share(other.storage_, other_constructed);
+                if (is_allocated())
+                    statistics().on_share(storage_.block().size());
+                return result;
+            }
+
+            /// \notes Copying a shared memory block counts as an allocation,
+            /// but the shared one isn't deallocated.
+            template <typename T, class S = BlockStorage>
+            auto unshare(const block_view<T>& constructed)
+                -> decltype(std::declval<S&>().unshare(constructed))
+            {
+                auto old_block     = storage_.block();
+                auto old_allocated = is_allocated();
+
+                auto result = storage_.unshare(constructed);
+                if (old_block.begin() != storage_.block().begin())
+                {
+                    statistics().on_release_shared(old_allocated ? old_block.size() : 0u);
+                    statistics().on_change(false, memory_block(), is_allocated(),
+                                           storage_.block(), old_block.size(),
+                                           constructed.size() * sizeof(T));
+                }
+                return result;
+            }
+
+            template <typename T, class S = BlockStorage>
+            auto release(const block_view<T>& constructed) noexcept
+                -> decltype(std::declval<S&>().release(constructed))
+            {
+                if (!is_allocated())
+                    return storage_.release(constructed);
+
+                auto size   = storage_.block().size();
+                auto shared = storage_.is_shared();
+                storage_.release(constructed);
+                if (shared)
+                    statistics().on_release_shared(size);
+                else
+                    statistics().on_destroy(size);
+            }
+
+            //=== accessors ===//
+            memory_block empty_block() const noexcept
+            {
+                return storage_.empty_block();
+            }
+
+            memory_block block() const noexcept
+            {
+                return storage_.block();
+            }
+
+            arg_type arguments() const noexcept
+            {
+                return storage_.arguments();
+            }
+
+            static size_type max_size(const arg_type& args) noexcept
+            {
+                return BlockStorage::max_size(args);
+            }
+
+        private:
+            bool is_allocated() const noexcept
+            {
+                return storage_.block().begin() != storage_.empty_block().begin();
+            }
+
+            BlockStorage storage_;
+        };
+    } // namespace array
+} // namespace foonathan
+
+#endif // FOONATHAN_ARRAY_BLOCK_STORAGE_INSTRUMENTED_HPP_INCLUDED
@@ -0,0 +1,114 @@
+// Copyright (C) 2018 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#ifndef FOONATHAN_ARRAY_BLOCK_STORAGE_MALLOC_HPP_INCLUDED
+#define FOONATHAN_ARRAY_BLOCK_STORAGE_MALLOC_HPP_INCLUDED
+
+#include <cassert>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+#include <foonathan/array/block_storage_heap.hpp>
+
+#ifndef FOONATHAN_ARRAY_HAS_MALLOC_USABLE_SIZE
+
+#if defined(__GLIBC__)
+/// \exclude
+#define FOONATHAN_ARRAY_HAS_MALLOC_USABLE_SIZE 1
+#else
+/// \exclude
+#define FOONATHAN_ARRAY_HAS_MALLOC_USABLE_SIZE 0
+#endif
+
+#endif
+
+#if FOONATHAN_ARRAY_HAS_MALLOC_USABLE_SIZE
+#include <malloc.h>
+#endif
+
+namespace foonathan
+{
+    namespace array
+    {
+        /// A `Heap` that uses `std::malloc()`.
+        ///
+        /// It provides `reallocate()`, so blocks of trivially copyable types will be resized using `std::realloc()`,
+        /// and `allocate_zeroed()` using `std::calloc()`.
+        /// If `malloc_usable_size()` is available,
+        /// the returned blocks have the real size of the allocation.
+        struct malloc_heap
+        {
+            struct handle_type
+            {
+            };
+
+            static memory_block allocate(handle_type&, size_type size, size_type alignment)
+            {
+                assert(alignment <= alignof(std::max_align_t) && "over-aligned types not supported");
+                (void)alignment;
+
+                auto ptr = std::malloc(size);
+                if (!ptr)
+                    throw std::bad_alloc();
+                return {to_raw_pointer(ptr), usable_size(ptr, size)};
+            }
+
+            /// \returns A zeroed block allocated using `std::calloc()`,
+            /// which can use fresh pages from the operating system without touching them.
+            static memory_block allocate_zeroed(handle_type&, size_type size, size_type alignment)
+            {
+                assert(alignment <= alignof(std::max_align_t) && "over-aligned types not supported");
+                (void)alignment;
+
+                auto ptr = std::calloc(1u, size);
+                if (!ptr)
+                    throw std::bad_alloc();
+                // only the requested size is guaranteed to be zero
+                return {to_raw_pointer(ptr), size};
+            }
+
+            static memory_block reallocate(handle_type&, memory_block&& block, size_type new_size,
+                                           size_type alignment)
+            {
+                assert(alignment <= alignof(std::max_align_t) && "over-aligned types not supported");
+                (void)alignment;
+
+                auto ptr = std::realloc(to_void_pointer(block.begin()), new_size);
+                if (!ptr)
+                    // old block is still valid
+                    throw std::bad_alloc();
+                return {to_raw_pointer(ptr), usable_size(ptr, new_size)};
+            }
+
+            static void deallocate(handle_type&, memory_block&& block) noexcept
+            {
+                std::free(to_void_pointer(block.begin()));
+            }
+
+            static size_type max_size(const handle_type&) noexcept
+            {
+                return memory_block::max_size();
+            }
+
+        private:
+            static size_type usable_size(void* ptr, size_type size) noexcept
+            {
+#if FOONATHAN_ARRAY_HAS_MALLOC_USABLE_SIZE
+                (void)size;
+                return ::malloc_usable_size(ptr);
+#else
+                (void)ptr;
+                return size;
+#endif
+            }
+        };
+
+        /// A `BlockStorage` that uses `std::malloc()` for memory allocations.
+        template <class GrowthPolicy = default_growth>
+        using block_storage_malloc = block_storage_heap<malloc_heap, GrowthPolicy>;
+    } // namespace array
+} // namespace foonathan
+
+#endif // FOONATHAN_ARRAY_BLOCK_STORAGE_MALLOC_HPP_INCLUDED
@@ -0,0 +1,368 @@
+// Copyright (C) 2018 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#ifndef FOONATHAN_ARRAY_BLOCK_STORAGE_MAPPED_FILE_HPP_INCLUDED
+#define FOONATHAN_ARRAY_BLOCK_STORAGE_MAPPED_FILE_HPP_INCLUDED
+
+#include <cerrno>
+#include <stdexcept>
+#include <system_error>
+#include <type_traits>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <foonathan/array/array_view.hpp>
+#include <foonathan/array/block_storage.hpp>
+#include <foonathan/array/growth_policy.hpp>
+
+namespace foonathan
+{
+    namespace array
+    {
+        namespace detail
+        {
+            [[noreturn]] inline void throw_errno(const char* what)
+            {
+                throw std::system_error(errno, std::generic_category(), what);
+            }
+        } // namespace detail
+
+        /// A file whose contents can be used as the memory of a [array::block_storage_mapped_file]().
+        ///
+        /// It must outlive all storages using it, and only one storage may map it at a time.
+        /// \requires A POSIX system.
+        class mapped_file
+        {
+        public:
+            /// \effects Opens the file for reading and writing, creating it if it doesn't exist.
+            /// \throws `std::system_error` if the file couldn't be opened.
+            explicit mapped_file(const char* path)
+            : fd_(::open(path, O_RDWR | O_CREAT, 0644)), in_use_(false)
+            {
+                if (fd_ == -1)
+                    detail::throw_errno("open");
+            }
+
+            /// \effects Takes ownership of an open file descriptor,
+            /// e.g. one of a shared memory object or one inherited from a parent process.
+            /// \throws `std::system_error` with the current `errno` if it is `-1`.
+            explicit mapped_file(int fd) : fd_(fd), in_use_(false)
+            {
+                if (fd_ == -1)
+                    detail::throw_errno("open");
+            }
+
+            mapped_file(const mapped_file&) = delete;
+            mapped_file& operator=(const mapped_file&) = delete;
+
+            ~mapped_file() noexcept
+            {
+                ::close(fd_);
+            }
+
+            /// \returns The file descriptor.
+            int native_handle() const noexcept
+            {
+                return fd_;
+            }
+
+            /// \returns The current size of the file in bytes.
+            /// \throws `std::system_error` if the size couldn't be determined.
+            size_type size() const
+            {
+                struct stat info;
+                if (::fstat(fd_, &info) != 0)
+                    detail::throw_errno("fstat");
+                return size_type(info.st_size);
+            }
+
+        private:
+            int  fd_;
+            bool in_use_;
+
+            template <class GrowthPolicy>
+            friend class block_storage_mapped_file;
+        };
+
+        /// A `BlockStorage` that uses a [array::mapped_file]() mapped with `MAP_SHARED` as memory.
+        ///
+        /// The memory block is the entire file: `reserve()` grows the file using `ftruncate()` and remaps it,
+        /// `shrink_to_fit()` truncates it to exactly the constructed objects.
+        /// So call `shrink_to_fit()` before the container is destroyed,
+        /// then the file contains the objects and nothing else.
+        /// Use `restore()` to create a container from the objects of an existing file without copying.
+        ///
+        /// Pass a pointer to the [array::mapped_file]() using [array::block_storage_arg]().
+        /// \requires A POSIX system, and `T` must be trivially copyable.
+        /// \notes As the file is used by one storage only,
+        /// containers that need multiple storages like [array::flat_map]() can't use it.
+        template <class GrowthPolicy = default_growth>
+        class block_storage_mapped_file
+        : block_storage_args_storage<block_storage_args_t<mapped_file*>>
+        {
+            using args_storage = block_storage_args_storage<block_storage_args_t<mapped_file*>>;
+
+        public:
+            using embedded_storage = std::false_type;
+            using arg_type         = block_storage_args_t<mapped_file*>;
+
+            //=== constructors/destructors ===//
+            explicit block_storage_mapped_file(arg_type args) noexcept
+            : args_storage(std::move(args)), begin_(nullptr), size_(0u)
+            {
+            }
+
+            ~block_storage_mapped_file() noexcept
+            {
+                if (begin_)
+                {
+                    ::munmap(to_void_pointer(begin_), size_);
+                    file().in_use_ = false;
+                }
+            }
+
+            block_storage_mapped_file(const block_storage_mapped_file&) = delete;
+            block_storage_mapped_file& operator=(const block_storage_mapped_file&) = delete;
+
+            template <typename T>
+            static void swap(block_storage_mapped_file& lhs, block_view<T>& lhs_constructed,
+                             block_storage_mapped_file& rhs,
+                             block_view<T>&             rhs_constructed) noexcept
+            {
+                std::swap(lhs.begin_, rhs.begin_);
+                std::swap(lhs.size_, rhs.size_);
+                std::swap(lhs_constructed, rhs_constructed);
+
+                auto tmp_args = lhs.arguments();
+                lhs.set_stored_arguments(rhs.arguments());
+                rhs.set_stored_arguments(std::move(tmp_args));
+            }
+
+            //=== restore ===//
+            /// \effects Maps the existing contents of the file.
+            /// \returns A view to the objects stored in it.
+            /// Pass it together with the storage to the [array::input_view]() constructor to create a container.
+            /// \throws `std::system_error` if the file couldn't be mapped,
+            /// `std::length_error` if the file size isn't a multiple of `sizeof(T)`.
+            /// \requires The storage must not own memory yet.
+            template <typename T>
+            block_view<T> restore()
+            {
+                static_assert(std::is_trivially_copyable<T>::value,
+                              "objects must be trivially copyable to be stored in a file");
+                assert(!begin_);
+
+                check_unused();
+                auto size = file().size();
+                if (size % sizeof(T) != 0u)
+                    throw std::length_error("file doesn't contain an array of the type");
+                remap(size);
+
+                return block_view<T>(to_pointer<T>(begin_), size / sizeof(T));
+            }
+
+            //=== reserve/shrink_to_fit ===//
+            template <typename T>
+            raw_pointer reserve(size_type min_additional_bytes, block_view<T> constructed)
+            {
+                static_assert(std::is_trivially_copyable<T>::value,
+                              "objects must be trivially copyable to be stored in a file");
+                constructed = move_to_front(*this, constructed);
+
+                auto used = constructed.size() * sizeof(T);
+                resize(GrowthPolicy::growth_size(size_, min_additional_bytes,
+                                                 max_size(arguments())));
+
+                // the block might not have existed before
+                return begin_ + used;
+            }
+
+            template <typename T>
+            raw_pointer shrink_to_fit(block_view<T> constructed)
+            {
+                static_assert(std::is_trivially_copyable<T>::value,
+                              "objects must be trivially copyable to be stored in a file");
+                constructed = move_to_front(*this, constructed);
+
+                // truncate exactly, so the file contains only the objects
+                auto used = constructed.size() * sizeof(T);
+                if (used != size_)
+                    resize(used);
+                return begin_ + used;
+            }
+
+            //=== accessors ===//
+            memory_block empty_block() const noexcept
+            {
+                return {};
+            }
+
+            memory_block block() const noexcept
+            {
+                return memory_block(begin_, size_);
+            }
+
+            arg_type arguments() const noexcept
+            {
+                return this->stored_arguments();
+            }
+
+            static size_type max_size(const arg_type&) noexcept
+            {
+                return memory_block::max_size();
+            }
+
+        private:
+            mapped_file& file() const noexcept
+            {
+                auto file = std::get<0>(this->stored_arguments().args);
+                assert(file);
+                return *file;
+            }
+
+            void resize(size_type new_size)
+            {
+                check_unused();
+                if (::ftruncate(file().native_handle(), off_t(new_size)) != 0)
+                    detail::throw_errno("ftruncate");
+                remap(new_size);
+            }
+
+            void check_unused() const
+            {
+                if (!begin_ && file().in_use_)
+                    throw std::logic_error("file is already mapped by another storage");
+            }
+
+            void remap(size_type new_size)
+            {
+                if (new_size == 0u)
+                {
+                    if (begin_)
+                        ::munmap(to_void_pointer(begin_), size_);
+                    begin_         = nullptr;
+                    size_          = 0u;
+                    file().in_use_ = false;
+                    return;
+                }
+
+#ifdef MREMAP_MAYMOVE
+                auto ptr = begin_ ? ::mremap(to_void_pointer(begin_), size_, new_size,
+                                             MREMAP_MAYMOVE) :
+                                    map(new_size);
+                if (ptr == MAP_FAILED)
+                    detail::throw_errno("mremap");
+#else
+                // the contents are in the file, so mapping it again doesn't need a copy
+                auto ptr = map(new_size);
+                if (ptr == MAP_FAILED)
+                    detail::throw_errno("mmap");
+                if (begin_)
+                    ::munmap(to_void_pointer(begin_), size_);
+#endif
+
+                begin_         = to_raw_pointer(ptr);
+                size_          = new_size;
+                file().in_use_ = true;
+            }
+
+            void* map(size_type size) const noexcept
+            {
+                return ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED,
+                              file().native_handle(), 0);
+            }
+
+            raw_pointer begin_;
+            size_type   size_;
+        };
+
+        /// A read-only mapping of a file containing objects of type `T`.
+        ///
+        /// Use it to access the objects written by a [array::block_storage_mapped_file]() from another process,
+        /// the memory is shared, not copied.
+        /// \requires A POSIX system, and `T` must be trivially copyable.
+        template <typename T>
+        class mapped_array_view
+        {
+            static_assert(std::is_trivially_copyable<T>::value,
+                          "objects must be trivially copyable to be stored in a file");
+
+        public:
+            /// \effects Maps the entire file with the given descriptor,
+            /// the descriptor can be closed afterwards.
+            /// \throws `std::system_error` if the file couldn't be mapped,
+            /// `std::length_error` if the file size isn't a multiple of `sizeof(T)`.
+            explicit mapped_array_view(int fd) : data_(nullptr), size_(0u)
+            {
+                struct stat info;
+                if (::fstat(fd, &info) != 0)
+                    detail::throw_errno("fstat");
+
+                auto size = size_type(info.st_size);
+                if (size % sizeof(T) != 0u)
+                    throw std::length_error("file doesn't contain an array of the type");
+                else if (size != 0u)
+                {
+                    auto ptr = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+                    if (ptr == MAP_FAILED)
+                        detail::throw_errno("mmap");
+                    data_ = static_cast<const T*>(ptr);
+                    size_ = size / sizeof(T);
+                }
+            }
+
+            mapped_array_view(mapped_array_view&& other) noexcept
+            : data_(other.data_), size_(other.size_)
+            {
+                other.data_ = nullptr;
+                other.size_ = 0u;
+            }
+
+            ~mapped_array_view() noexcept
+            {
+                if (data_)
+                    ::munmap(const_cast<T*>(data_), size_ * sizeof(T));
+            }
+
+            mapped_array_view& operator=(mapped_array_view&& other) noexcept
+            {
+                mapped_array_view tmp(std::move(other));
+                std::swap(data_, tmp.data_);
+                std::swap(size_, tmp.size_);
+                return *this;
+            }
+
+            /// \returns A view to the objects.
+            operator array_view<const T>() const noexcept
+            {
+                return view();
+            }
+
+            /// \returns A view to the objects.
+            array_view<const T> view() const noexcept
+            {
+                return array_view<const T>(data_, size_);
+            }
+
+            const T* data() const noexcept
+            {
+                return data_;
+            }
+
+            size_type size() const noexcept
+            {
+                return size_;
+            }
+
+        private:
+            const T*  data_;
+            size_type size_;
+        };
+    } // namespace array
+} // namespace foonathan
+
+#endif // FOONATHAN_ARRAY_BLOCK_STORAGE_MAPPED_FILE_HPP_INCLUDED
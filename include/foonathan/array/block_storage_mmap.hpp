@@ -0,0 +1,226 @@
+// Copyright (C) 2018 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#ifndef FOONATHAN_ARRAY_BLOCK_STORAGE_MMAP_HPP_INCLUDED
+#define FOONATHAN_ARRAY_BLOCK_STORAGE_MMAP_HPP_INCLUDED
+
+#include <cstring>
+#include <new>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <foonathan/array/block_storage_heap.hpp>
+#include <foonathan/array/block_storage_new.hpp>
+
+namespace foonathan
+{
+    namespace array
+    {
+        namespace detail
+        {
+            inline size_type page_size() noexcept
+            {
+                static const auto size = size_type(::sysconf(_SC_PAGESIZE));
+                return size;
+            }
+
+            inline size_type round_up(size_type size, size_type multiple) noexcept
+            {
+                return (size + multiple - 1u) / multiple * multiple;
+            }
+        } // namespace detail
+
+        /// Controls whether or not an [array::mmap_heap]() uses huge pages.
+        enum class huge_page_mode
+        {
+            disabled,    //< Use normal pages.
+            advise,      //< Use transparent huge pages by calling `madvise(MADV_HUGEPAGE)`.
+            map_hugetlb, //< Use `MAP_HUGETLB`, falls back to `advise` if no huge pages are available.
+        };
+
+        /// A `Heap` that allocates big blocks directly using `mmap()`.
+        ///
+        /// Blocks smaller than the threshold of the handle are allocated using the [array::new_heap]().
+        /// Blocks allocated using `mmap()` are rounded up to the page size,
+        /// or the huge page size, if huge pages are enabled.
+        ///
+        /// On Linux, it provides `try_expand()` and `reallocate()` using `mremap()`,
+        /// so mapped blocks of trivially relocatable types grow without copying the elements.
+        /// \requires A POSIX system.
+        struct mmap_heap
+        {
+            /// The default threshold.
+            static constexpr size_type default_threshold = 1024u * 1024u;
+
+            /// The size of a huge page.
+            static constexpr size_type huge_page_size = 2u * 1024u * 1024u;
+
+            class handle_type
+            {
+            public:
+                /// \effects Creates a handle with the default threshold that uses transparent huge pages.
+                handle_type() noexcept : handle_type(default_threshold, huge_page_mode::advise) {}
+
+                /// \effects Creates a handle where all blocks of at least `threshold` bytes are allocated using `mmap()`,
+                /// using huge pages as specified by the mode.
+                explicit handle_type(size_type threshold,
+                                     huge_page_mode mode = huge_page_mode::advise) noexcept
+                : threshold_(threshold), mode_(mode)
+                {
+                }
+
+                size_type threshold() const noexcept
+                {
+                    return threshold_;
+                }
+
+                huge_page_mode huge_pages() const noexcept
+                {
+                    return mode_;
+                }
+
+            private:
+                size_type      threshold_;
+                huge_page_mode mode_;
+            };
+
+            /// \returns Whether or not a block of the given size is allocated using `mmap()`.
+            static bool is_mapped(const handle_type& handle, size_type size) noexcept
+            {
+                return size >= handle.threshold();
+            }
+
+            static memory_block allocate(handle_type& handle, size_type size, size_type alignment)
+            {
+                if (!is_mapped(handle, size))
+                {
+                    new_heap::handle_type new_handle;
+                    return new_heap::allocate(new_handle, size, alignment);
+                }
+
+                // mmap() returns page aligned memory, so alignment is no problem
+                auto mode = handle.huge_pages();
+                if (mode == huge_page_mode::map_hugetlb)
+                {
+#ifdef MAP_HUGETLB
+                    auto huge_size = detail::round_up(size, huge_page_size);
+                    auto ptr       = map(huge_size, MAP_HUGETLB);
+                    if (ptr != MAP_FAILED)
+                        return memory_block(to_raw_pointer(ptr), huge_size);
+#endif
+                    // no huge pages reserved, use transparent ones instead
+                    mode = huge_page_mode::advise;
+                }
+
+                auto mapped_size = detail::round_up(size, granularity(handle));
+                auto ptr         = map(mapped_size, 0);
+                if (ptr == MAP_FAILED)
+                    throw std::bad_alloc();
+#ifdef MADV_HUGEPAGE
+                if (mode == huge_page_mode::advise)
+                    // just a hint, so ignore errors
+                    ::madvise(ptr, mapped_size, MADV_HUGEPAGE);
+#endif
+                return memory_block(to_raw_pointer(ptr), mapped_size);
+            }
+
+            /// \returns A zeroed block, mapped blocks are already zeroed by the operating system.
+            static memory_block allocate_zeroed(handle_type& handle, size_type size,
+                                                size_type alignment)
+            {
+                auto block = allocate(handle, size, alignment);
+                if (!is_mapped(handle, size))
+                    std::memset(to_void_pointer(block.begin()), 0, block.size());
+                return block;
+            }
+
+            /// \returns The size rounded up to the (huge) page size, if it would be mapped.
+            static size_type good_size(const handle_type& handle, size_type size) noexcept
+            {
+                if (is_mapped(handle, size))
+                    return detail::round_up(size, granularity(handle));
+                else
+                    return size;
+            }
+
+            static void deallocate(handle_type& handle, memory_block&& block) noexcept
+            {
+                if (is_mapped(handle, block.size()))
+                    ::munmap(to_void_pointer(block.begin()), block.size());
+                else
+                {
+                    new_heap::handle_type new_handle;
+                    new_heap::deallocate(new_handle, std::move(block));
+                }
+            }
+
+#ifdef MREMAP_MAYMOVE
+            static bool try_expand(handle_type& handle, memory_block& block,
+                                   size_type new_size) noexcept
+            {
+                if (!is_mapped(handle, block.size()))
+                    return false;
+
+                auto mapped_size = detail::round_up(new_size, granularity(handle));
+                auto ptr         =
+                    ::mremap(to_void_pointer(block.begin()), block.size(), mapped_size, 0);
+                if (ptr == MAP_FAILED)
+                    return false;
+                block = memory_block(block.begin(), mapped_size);
+                return true;
+            }
+
+            static memory_block reallocate(handle_type& handle, memory_block&& block,
+                                           size_type new_size, size_type alignment)
+            {
+                if (is_mapped(handle, block.size()) && is_mapped(handle, new_size))
+                {
+                    // let the kernel move the pages instead of copying them
+                    auto mapped_size = detail::round_up(new_size, granularity(handle));
+                    auto ptr         = ::mremap(to_void_pointer(block.begin()), block.size(),
+                                                mapped_size, MREMAP_MAYMOVE);
+                    if (ptr != MAP_FAILED)
+                        return memory_block(to_raw_pointer(ptr), mapped_size);
+                    // it can fail for huge pages, so copy instead
+                }
+
+                // crosses the threshold or couldn't be remapped, so allocate a new block and copy
+                auto new_block = allocate(handle, new_size, alignment);
+                std::memcpy(to_void_pointer(new_block.begin()), to_void_pointer(block.begin()),
+                            block.size() < new_size ? block.size() : new_size);
+                deallocate(handle, std::move(block));
+                return new_block;
+            }
+#endif
+
+            static size_type max_size(const handle_type&) noexcept
+            {
+                return memory_block::max_size();
+            }
+
+        private:
+            // the size mapped blocks are rounded up to
+            static size_type granularity(const handle_type& handle) noexcept
+            {
+                return handle.huge_pages() == huge_page_mode::disabled ? detail::page_size()
+                                                                       : huge_page_size;
+            }
+
+            static void* map(size_type size, int flags) noexcept
+            {
+                return ::mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                              MAP_PRIVATE | MAP_ANONYMOUS | flags, -1, 0);
+            }
+        };
+
+        /// A `BlockStorage` that uses the [array::mmap_heap]() for memory allocations.
+        ///
+        /// Pass an [array::mmap_heap::handle_type]() using [array::block_storage_arg]() to control the threshold and huge pages.
+        template <class GrowthPolicy = default_growth>
+        using block_storage_mmap = block_storage_heap<mmap_heap, GrowthPolicy>;
+    } // namespace array
+} // namespace foonathan
+
+#endif // FOONATHAN_ARRAY_BLOCK_STORAGE_MMAP_HPP_INCLUDED
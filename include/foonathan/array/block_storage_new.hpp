@@ -8,12 +8,15 @@
 #include <new>
 
 #include <foonathan/array/block_storage_heap.hpp>
+#include <foonathan/array/config.hpp>
 
 namespace foonathan
 {
     namespace array
     {
         /// A `Heap` that uses `::operator new`.
+        ///
+        /// If available, it uses sized deallocation.
         struct new_heap
         {
             struct handle_type
@@ -28,7 +31,11 @@ namespace foonathan
 
             static void deallocate(handle_type&, memory_block&& block) noexcept
             {
+#if FOONATHAN_ARRAY_HAS_SIZED_DEALLOCATION
+                ::operator delete[](to_void_pointer(block.begin()), block.size());
+#else
                 ::operator delete[](to_void_pointer(block.begin()));
+#endif
             }
 
             static size_type max_size(const handle_type&) noexcept
@@ -0,0 +1,321 @@
+// Copyright (C) 2018 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#ifndef FOONATHAN_ARRAY_BLOCK_STORAGE_POOL_HPP_INCLUDED
+#define FOONATHAN_ARRAY_BLOCK_STORAGE_POOL_HPP_INCLUDED
+
+#include <atomic>
+#include <cstddef>
+#include <new>
+
+#include <foonathan/array/block_storage_heap.hpp>
+#include <foonathan/array/block_storage_new.hpp>
+
+namespace foonathan
+{
+    namespace array
+    {
+        namespace detail
+        {
+            class pool_cache;
+
+            // in front of every block of the pool
+            struct alignas(std::max_align_t) pool_block_header
+            {
+                pool_cache* owner; // nullptr if not owned by any cache
+                std::size_t size_class;
+            };
+
+            // a free block, stored in the memory of the block after the header
+            struct pool_free_block
+            {
+                pool_block_header* next;
+            };
+
+            constexpr std::size_t pool_min_class_size = 16u;
+            constexpr std::size_t pool_no_classes     = 13u; // up to 64 KiB
+
+            inline std::size_t pool_class_size(std::size_t size_class) noexcept
+            {
+                return pool_min_class_size << size_class;
+            }
+
+            inline std::size_t pool_size_class(std::size_t size) noexcept
+            {
+                auto size_class = std::size_t(0);
+                while (pool_class_size(size_class) < size)
+                    ++size_class;
+                return size_class;
+            }
+
+            inline raw_pointer pool_block_memory(pool_block_header* header) noexcept
+            {
+                return to_raw_pointer(header) + sizeof(pool_block_header);
+            }
+
+            inline pool_block_header* pool_block_header_of(raw_pointer memory) noexcept
+            {
+                return reinterpret_cast<pool_block_header*>(memory - sizeof(pool_block_header));
+            }
+
+            inline pool_block_header*& pool_next(pool_block_header* header) noexcept
+            {
+                return reinterpret_cast<pool_free_block*>(pool_block_memory(header))->next;
+            }
+
+            // the free lists of one thread
+            // caches are never destroyed, when a thread exits, it is adopted by a new one
+            class pool_cache
+            {
+            public:
+                pool_cache() noexcept : remote_(nullptr), in_use_(true), next_(nullptr)
+                {
+                    for (auto& list : free_)
+                        list = nullptr;
+                }
+
+                pool_cache(const pool_cache&) = delete;
+                pool_cache& operator=(const pool_cache&) = delete;
+
+                pool_block_header* allocate(std::size_t size_class)
+                {
+                    if (!free_[size_class])
+                        // maybe other threads have returned some
+                        collect_remote();
+
+                    auto header = free_[size_class];
+                    if (header)
+                        free_[size_class] = pool_next(header);
+                    else
+                        header = new_block(this, size_class);
+                    return header;
+                }
+
+                // must be called by the thread owning the cache
+                void deallocate_local(pool_block_header* header) noexcept
+                {
+                    pool_next(header)         = free_[header->size_class];
+                    free_[header->size_class] = header;
+                }
+
+                // can be called by any thread
+                void deallocate_remote(pool_block_header* header) noexcept
+                {
+                    auto head = remote_.load(std::memory_order_relaxed);
+                    do
+                    {
+                        pool_next(header) = head;
+                    } while (!remote_.compare_exchange_weak(head, header, std::memory_order_release,
+                                                            std::memory_order_relaxed));
+                }
+
+                static pool_block_header* new_block(pool_cache* owner, std::size_t size_class)
+                {
+                    auto memory = ::operator new(sizeof(pool_block_header)
+                                                 + pool_class_size(size_class));
+                    return ::new (memory) pool_block_header{owner, size_class};
+                }
+
+                static void delete_block(pool_block_header* header) noexcept
+                {
+                    ::operator delete(header);
+                }
+
+                //=== thread management ===//
+                // returns an abandoned cache or creates a new one
+                static pool_cache* acquire()
+                {
+                    auto cur = registry().load(std::memory_order_acquire);
+                    while (cur)
+                    {
+                        auto in_use = false;
+                        if (cur->in_use_.compare_exchange_strong(in_use, true,
+                                                                 std::memory_order_acquire))
+                            return cur;
+                        cur = cur->next_;
+                    }
+
+                    auto cache   = new pool_cache;
+                    cache->next_ = registry().load(std::memory_order_relaxed);
+                    while (!registry().compare_exchange_weak(cache->next_, cache,
+                                                             std::memory_order_release,
+                                                             std::memory_order_relaxed))
+                    {
+                    }
+                    return cache;
+                }
+
+                // gives the memory back and marks the cache as abandoned
+                void release() noexcept
+                {
+                    collect_remote();
+                    for (auto& list : free_)
+                    {
+                        while (list)
+                        {
+                            auto next = pool_next(list);
+                            delete_block(list);
+                            list = next;
+                        }
+                    }
+
+                    in_use_.store(false, std::memory_order_release);
+                }
+
+            private:
+                static std::atomic<pool_cache*>& registry() noexcept
+                {
+                    static std::atomic<pool_cache*> head(nullptr);
+                    return head;
+                }
+
+                void collect_remote() noexcept
+                {
+                    auto header = remote_.exchange(nullptr, std::memory_order_acquire);
+                    while (header)
+                    {
+                        auto next = pool_next(header);
+                        deallocate_local(header);
+                        header = next;
+                    }
+                }
+
+                pool_block_header*              free_[pool_no_classes];
+                std::atomic<pool_block_header*> remote_;
+                std::atomic<bool>               in_use_;
+                pool_cache*                     next_;
+            };
+
+            // the cache of the current thread
+            class pool_thread
+            {
+            public:
+                // returns nullptr if the thread is already exiting
+                static pool_cache* cache()
+                {
+                    if (!cache_ptr() && !exited())
+                    {
+                        cache_ptr() = pool_cache::acquire();
+                        // registers the destructor
+                        guard().active = true;
+                    }
+                    return cache_ptr();
+                }
+
+                // returns the cache if it has already been created
+                static pool_cache* cache_if_created() noexcept
+                {
+                    return cache_ptr();
+                }
+
+            private:
+                struct guard_t
+                {
+                    bool active = false;
+
+                    ~guard_t() noexcept
+                    {
+                        exited() = true;
+                        if (auto cache = cache_ptr())
+                        {
+                            cache_ptr() = nullptr;
+                            cache->release();
+                        }
+                    }
+                };
+
+                static pool_cache*& cache_ptr() noexcept
+                {
+                    static thread_local pool_cache* ptr = nullptr;
+                    return ptr;
+                }
+
+                static bool& exited() noexcept
+                {
+                    static thread_local bool value = false;
+                    return value;
+                }
+
+                static guard_t& guard() noexcept
+                {
+                    static thread_local guard_t g;
+                    return g;
+                }
+            };
+        } // namespace detail
+
+        /// A `Heap` that serves small blocks from thread local free lists.
+        ///
+        /// Blocks up to 64 KiB are rounded up to the next power of two,
+        /// each size class has a free list per thread.
+        /// Blocks freed by a different thread are returned to the owning thread using a lock-free stack.
+        /// If a thread exits, its free lists are given back and a new thread will reuse its cache.
+        /// Bigger blocks are allocated using the [array::new_heap]().
+        struct pool_heap
+        {
+            struct handle_type
+            {
+            };
+
+            /// The biggest block size that is pooled.
+            static constexpr size_type max_pooled_size =
+                detail::pool_min_class_size << (detail::pool_no_classes - 1u);
+
+            static memory_block allocate(handle_type&, size_type size, size_type alignment)
+            {
+                if (size > max_pooled_size)
+                {
+                    new_heap::handle_type new_handle;
+                    return new_heap::allocate(new_handle, size, alignment);
+                }
+
+                auto size_class = detail::pool_size_class(size);
+                auto cache      = detail::pool_thread::cache();
+                auto header     = cache ? cache->allocate(size_class)
+                                        : detail::pool_cache::new_block(nullptr, size_class);
+                return memory_block(detail::pool_block_memory(header),
+                                    detail::pool_class_size(size_class));
+            }
+
+            /// \returns The size of the size class for pooled blocks, the size itself otherwise.
+            static size_type good_size(const handle_type&, size_type size) noexcept
+            {
+                if (size > max_pooled_size)
+                    return size;
+                else
+                    return detail::pool_class_size(detail::pool_size_class(size));
+            }
+
+            static void deallocate(handle_type&, memory_block&& block) noexcept
+            {
+                if (block.size() > max_pooled_size)
+                {
+                    new_heap::handle_type new_handle;
+                    new_heap::deallocate(new_handle, std::move(block));
+                    return;
+                }
+
+                auto header = detail::pool_block_header_of(block.begin());
+                auto owner  = header->owner;
+                if (!owner)
+                    detail::pool_cache::delete_block(header);
+                else if (owner == detail::pool_thread::cache_if_created())
+                    owner->deallocate_local(header);
+                else
+                    owner->deallocate_remote(header);
+            }
+
+            static size_type max_size(const handle_type&) noexcept
+            {
+                return memory_block::max_size();
+            }
+        };
+
+        /// A `BlockStorage` that uses the [array::pool_heap]() for memory allocations.
+        template <class GrowthPolicy = default_growth>
+        using block_storage_pool = block_storage_heap<pool_heap, GrowthPolicy>;
+    } // namespace array
+} // namespace foonathan
+
+#endif // FOONATHAN_ARRAY_BLOCK_STORAGE_POOL_HPP_INCLUDED
@@ -24,6 +24,7 @@ namespace foonathan
         public:
             using embedded_storage = std::true_type;
             using arg_type         = typename BigBlockStorage::arg_type;
+            using auto_shrink      = block_storage_auto_shrink<BigBlockStorage>;
 
             static constexpr std::size_t small_buffer_size =
                 SmallBufferBytes < sizeof(BigBlockStorage) ? sizeof(BigBlockStorage) :
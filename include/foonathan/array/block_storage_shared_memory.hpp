@@ -0,0 +1,70 @@
+// Copyright (C) 2018 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#ifndef FOONATHAN_ARRAY_BLOCK_STORAGE_SHARED_MEMORY_HPP_INCLUDED
+#define FOONATHAN_ARRAY_BLOCK_STORAGE_SHARED_MEMORY_HPP_INCLUDED
+
+#include <atomic>
+#include <string>
+
+#include <foonathan/array/block_storage_mapped_file.hpp>
+
+namespace foonathan
+{
+    namespace array
+    {
+        /// \returns The file descriptor of the POSIX shared memory object with the given name,
+        /// opened using `shm_open()` with the given flags.
+        /// \throws `std::system_error` if it couldn't be opened.
+        /// \notes Use `O_RDONLY` to open it for a [array::mapped_array_view]().
+        inline int open_shared_memory(const char* name, int flags = O_RDWR | O_CREAT)
+        {
+            auto fd = ::shm_open(name, flags, 0600);
+            if (fd == -1)
+                detail::throw_errno("shm_open");
+            return fd;
+        }
+
+        /// \effects Removes the name of the POSIX shared memory object,
+        /// the memory is freed once all processes have closed and unmapped it.
+        inline void unlink_shared_memory(const char* name) noexcept
+        {
+            ::shm_unlink(name);
+        }
+
+        /// \returns The file descriptor of a new shared memory object without a name.
+        /// It is shared with child processes by inheriting the descriptor.
+        /// \throws `std::system_error` if it couldn't be created.
+        /// \notes It uses `memfd_create()` if available,
+        /// otherwise it creates a unique named object and unlinks it immediately.
+        inline int anonymous_shared_memory()
+        {
+#ifdef MFD_CLOEXEC
+            auto fd = ::memfd_create("foonathan_array", 0u);
+            if (fd == -1)
+                detail::throw_errno("memfd_create");
+            return fd;
+#else
+            static std::atomic<unsigned> counter(0u);
+            auto name = "/foonathan_array_" + std::to_string(::getpid()) + "_"
+                        + std::to_string(counter.fetch_add(1u));
+
+            auto fd = open_shared_memory(name.c_str(), O_RDWR | O_CREAT | O_EXCL);
+            unlink_shared_memory(name.c_str());
+            return fd;
+#endif
+        }
+
+        /// A `BlockStorage` that uses shared memory.
+        ///
+        /// Pass a pointer to a [array::mapped_file]() created from [array::open_shared_memory]()
+        /// or [array::anonymous_shared_memory]() using [array::block_storage_arg]().
+        /// After `shrink_to_fit()`, other processes can map the objects using [array::mapped_array_view]().
+        /// \requires A POSIX system, and `T` must be trivially copyable.
+        template <class GrowthPolicy = default_growth>
+        using block_storage_shared_memory = block_storage_mapped_file<GrowthPolicy>;
+    } // namespace array
+} // namespace foonathan
+
+#endif // FOONATHAN_ARRAY_BLOCK_STORAGE_SHARED_MEMORY_HPP_INCLUDED
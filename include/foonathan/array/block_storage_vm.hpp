@@ -0,0 +1,166 @@
+// Copyright (C) 2018 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#ifndef FOONATHAN_ARRAY_BLOCK_STORAGE_VM_HPP_INCLUDED
+#define FOONATHAN_ARRAY_BLOCK_STORAGE_VM_HPP_INCLUDED
+
+#include <exception>
+#include <new>
+
+#include <sys/mman.h>
+
+#include <foonathan/array/block_storage.hpp>
+#include <foonathan/array/block_storage_mmap.hpp>
+
+namespace foonathan
+{
+    namespace array
+    {
+        /// Exception thrown when [array::block_storage_vm]() is exhausted.
+        class vm_storage_overflow : public std::exception
+        {
+        public:
+            const char* what() const noexcept override
+            {
+                return "overflow of a virtual memory storage";
+            }
+        };
+
+        /// A `BlockStorage` that reserves `MaxBytes` of virtual memory and commits it on demand.
+        ///
+        /// The address space is reserved on the first allocation,
+        /// `reserve()` then just commits more pages, it never moves the objects.
+        /// So pointers to the elements stay valid for the lifetime of the storage,
+        /// and growth is without copying.
+        /// `shrink_to_fit()` returns the unused pages to the OS but keeps the address space.
+        /// \requires A POSIX system.
+        template <std::size_t MaxBytes>
+        class block_storage_vm
+        {
+            static_assert(MaxBytes > 0u, "need to reserve some memory");
+
+        public:
+            using embedded_storage = std::false_type;
+            using arg_type         = block_storage_args_t<>;
+
+            //=== constructors/destructors ===//
+            explicit block_storage_vm(arg_type) noexcept : begin_(nullptr), committed_(0u) {}
+
+            ~block_storage_vm() noexcept
+            {
+                if (begin_)
+                    ::munmap(to_void_pointer(begin_), reserved_size());
+            }
+
+            block_storage_vm(const block_storage_vm&) = delete;
+            block_storage_vm& operator=(const block_storage_vm&) = delete;
+
+            template <typename T>
+            static void swap(block_storage_vm& lhs, block_view<T>& lhs_constructed,
+                             block_storage_vm& rhs, block_view<T>& rhs_constructed) noexcept
+            {
+                std::swap(lhs.begin_, rhs.begin_);
+                std::swap(lhs.committed_, rhs.committed_);
+                std::swap(lhs_constructed, rhs_constructed);
+            }
+
+            //=== reserve/shrink_to_fit ===//
+            template <typename T>
+            raw_pointer reserve(size_type min_additional_bytes, block_view<T> constructed)
+            {
+                constructed = move_to_front(*this, constructed);
+
+                // the growth is relative to the current block, not the constructed objects
+                auto cur_size = block().size();
+                if (min_additional_bytes > MaxBytes - cur_size)
+                    throw vm_storage_overflow();
+                else if (min_additional_bytes > 0u)
+                {
+                    // at least double to keep the number of system calls low
+                    auto new_size = cur_size + min_additional_bytes;
+                    if (new_size < 2 * committed_)
+                        new_size = 2 * committed_;
+                    commit(new_size);
+                }
+
+                // the block might not have existed before
+                return begin_ + constructed.size() * sizeof(T);
+            }
+
+            template <typename T>
+            raw_pointer shrink_to_fit(block_view<T> constructed)
+            {
+                constructed = move_to_front(*this, constructed);
+
+                auto new_committed = detail::round_up(constructed.size() * sizeof(T),
+                                                      detail::page_size());
+                if (new_committed < committed_)
+                {
+                    // give the memory back to the OS, but keep the address space
+                    auto ptr  = to_void_pointer(begin_ + new_committed);
+                    auto size = committed_ - new_committed;
+                    ::madvise(ptr, size, MADV_DONTNEED);
+                    ::mprotect(ptr, size, PROT_NONE);
+                    committed_ = new_committed;
+                }
+
+                return to_raw_pointer(constructed.data_end());
+            }
+
+            //=== accessors ===//
+            memory_block empty_block() const noexcept
+            {
+                return {};
+            }
+
+            memory_block block() const noexcept
+            {
+                // the committed memory can be bigger due to rounding
+                return memory_block(begin_, committed_ < MaxBytes ? committed_ : MaxBytes);
+            }
+
+            arg_type arguments() const noexcept
+            {
+                return {};
+            }
+
+            static size_type max_size(const arg_type&) noexcept
+            {
+                return MaxBytes;
+            }
+
+        private:
+            static size_type reserved_size() noexcept
+            {
+                return detail::round_up(MaxBytes, detail::page_size());
+            }
+
+            void commit(size_type size)
+            {
+                if (!begin_)
+                {
+                    auto ptr = ::mmap(nullptr, reserved_size(), PROT_NONE,
+                                      MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+                    if (ptr == MAP_FAILED)
+                        throw std::bad_alloc();
+                    begin_ = to_raw_pointer(ptr);
+                }
+
+                auto new_committed = detail::round_up(size, detail::page_size());
+                if (new_committed > reserved_size())
+                    new_committed = reserved_size();
+                if (::mprotect(to_void_pointer(begin_ + committed_), new_committed - committed_,
+                               PROT_READ | PROT_WRITE)
+                    != 0)
+                    throw std::bad_alloc();
+                committed_ = new_committed;
+            }
+
+            raw_pointer begin_;
+            size_type   committed_;
+        };
+    } // namespace array
+} // namespace foonathan
+
+#endif // FOONATHAN_ARRAY_BLOCK_STORAGE_VM_HPP_INCLUDED
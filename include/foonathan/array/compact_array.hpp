@@ -0,0 +1,435 @@
+// Copyright (C) 2018 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#ifndef FOONATHAN_ARRAY_COMPACT_ARRAY_HPP_INCLUDED
+#define FOONATHAN_ARRAY_COMPACT_ARRAY_HPP_INCLUDED
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+
+#include <foonathan/array/array_view.hpp>
+#include <foonathan/array/block_storage_new.hpp>
+#include <foonathan/array/pointer_iterator.hpp>
+
+namespace foonathan
+{
+    namespace array
+    {
+        /// An array of elements that stores a pointer and 32bit size and capacity, i.e. 16 bytes on 64bit platforms.
+        ///
+        /// Use it instead of [array::array]() if you have many small arrays,
+        /// e.g. the adjacency lists of a graph.
+        /// It uses the given `Heap` for (de-)allocation and the given `GrowthPolicy` to control the size,
+        /// like [array::block_storage_heap](), including the optional `try_expand()`, `reallocate()` and `good_size()`.
+        /// \requires The `Heap::handle_type` must be an empty type, as it isn't stored,
+        /// and `alignof(T)` must not be bigger than `alignof(std::max_align_t)`.
+        /// \notes It can't contain more than `UINT32_MAX` elements,
+        /// inserting more throws `std::length_error`.
+        template <typename T, class Heap = new_heap, class GrowthPolicy = default_growth>
+        class compact_array
+        {
+            static_assert(std::is_empty<typename Heap::handle_type>::value,
+                          "heap handle must be stateless");
+            static_assert(alignof(T) <= detail::max_heap_alignment,
+                          "over-aligned types are not supported");
+
+        public:
+            class iterator_tag
+            {
+                constexpr iterator_tag() = default;
+
+                friend compact_array;
+            };
+
+        public:
+            using value_type = T;
+
+            using iterator       = pointer_iterator<iterator_tag, T>;
+            using const_iterator = pointer_iterator<iterator_tag, const T>;
+
+            //=== constructors/destructors ===//
+            /// Default constructor.
+            /// \effects Creates an array without any elements.
+            compact_array() noexcept : data_(nullptr), size_(0u), capacity_(0u) {}
+
+            /// \effects Creates an array containing copies of the elements in the view.
+            explicit compact_array(array_view<const T> view) : compact_array()
+            {
+                append_range(view.begin(), view.end());
+            }
+
+            /// Copy constructor.
+            compact_array(const compact_array& other) : compact_array(other.view())
+            {
+            }
+
+            /// Move constructor.
+            compact_array(compact_array&& other) noexcept
+            : data_(other.data_), size_(other.size_), capacity_(other.capacity_)
+            {
+                other.data_     = nullptr;
+                other.size_     = 0u;
+                other.capacity_ = 0u;
+            }
+
+            /// Destructor.
+            ~compact_array() noexcept
+            {
+                destroy_range(begin(), end());
+                deallocate(data_, capacity_);
+            }
+
+            /// Copy assignment operator.
+            compact_array& operator=(const compact_array& other)
+            {
+                compact_array tmp(other);
+                swap(*this, tmp);
+                return *this;
+            }
+
+            /// Move assignment operator.
+            compact_array& operator=(compact_array&& other) noexcept
+            {
+                compact_array tmp(std::move(other));
+                swap(*this, tmp);
+                return *this;
+            }
+
+            /// Swap.
+            friend void swap(compact_array& lhs, compact_array& rhs) noexcept
+            {
+                std::swap(lhs.data_, rhs.data_);
+                std::swap(lhs.size_, rhs.size_);
+                std::swap(lhs.capacity_, rhs.capacity_);
+            }
+
+            //=== access ===//
+            /// \returns An array view to the elements.
+            operator array_view<T>() noexcept
+            {
+                return array_view<T>(data_, size_);
+            }
+            /// \returns A `const` array view to the elements.
+            operator array_view<const T>() const noexcept
+            {
+                return view();
+            }
+
+            iterator begin() noexcept
+            {
+                return iterator(iterator_tag{}, data_);
+            }
+            const_iterator begin() const noexcept
+            {
+                return cbegin();
+            }
+            const_iterator cbegin() const noexcept
+            {
+                return const_iterator(iterator_tag{}, data_);
+            }
+
+            iterator end() noexcept
+            {
+                return iterator(iterator_tag{}, data_ + size_);
+            }
+            const_iterator end() const noexcept
+            {
+                return cend();
+            }
+            const_iterator cend() const noexcept
+            {
+                return const_iterator(iterator_tag{}, data_ + size_);
+            }
+
+            T& operator[](size_type i) noexcept
+            {
+                return data_[i];
+            }
+            const T& operator[](size_type i) const noexcept
+            {
+                return data_[i];
+            }
+
+            T& front() noexcept
+            {
+                return data_[0];
+            }
+            const T& front() const noexcept
+            {
+                return data_[0];
+            }
+
+            T& back() noexcept
+            {
+                return data_[size_ - 1u];
+            }
+            const T& back() const noexcept
+            {
+                return data_[size_ - 1u];
+            }
+
+            //=== capacity ===//
+            /// \returns Whether or not the array is empty.
+            bool empty() const noexcept
+            {
+                return size_ == 0u;
+            }
+
+            /// \returns The number of elements in the array.
+            size_type size() const noexcept
+            {
+                return size_;
+            }
+
+            /// \returns The number of elements the array can contain without reserving new memory.
+            size_type capacity() const noexcept
+            {
+                return capacity_;
+            }
+
+            /// \returns The maximum number of elements,
+            /// the minimum of `UINT32_MAX` and the maximum size of the `Heap`.
+            static size_type max_size() noexcept
+            {
+                typename Heap::handle_type handle;
+                auto heap_max = Heap::max_size(handle) / sizeof(T);
+                return heap_max < UINT32_MAX ? heap_max : UINT32_MAX;
+            }
+
+            /// \effects Reserves new memory to make capacity as least as big as `new_capacity` if that isn't the case already.
+            /// \throws `std::length_error` if `new_capacity > max_size()`,
+            /// or anything thrown by the allocation function or move constructor of `T`.
+            void reserve(size_type new_capacity)
+            {
+                if (new_capacity > capacity_)
+                {
+                    check_size(new_capacity);
+                    auto new_size =
+                        GrowthPolicy::growth_size(capacity_ * sizeof(T),
+                                                  (new_capacity - capacity_) * sizeof(T),
+                                                  max_size() * sizeof(T));
+                    resize_block(good_size(detail::heap_has_good_size<Heap>{}, new_size));
+                }
+            }
+
+            /// \effects Non-binding request to make the capacity as small as necessary.
+            void shrink_to_fit()
+            {
+                auto new_size = good_size(detail::heap_has_good_size<Heap>{},
+                                          GrowthPolicy::shrink_size(capacity_ * sizeof(T),
+                                                                    size_ * sizeof(T),
+                                                                    max_size() * sizeof(T)));
+                if (new_size / sizeof(T) < capacity_)
+                    resize_block(new_size);
+            }
+
+            //=== modifiers ===//
+            /// \effects Creates a new element at the end.
+            /// \returns A reference to the new element.
+            template <typename... Args>
+            T& emplace_back(Args&&... args)
+            {
+                if (size_ == capacity_)
+                    reserve(size() + 1u);
+                auto ptr = construct_object<T>(to_raw_pointer(data_ + size_),
+                                               std::forward<Args>(args)...);
+                ++size_;
+                return *ptr;
+            }
+
+            /// \effects Same as `emplace_back(element)`.
+            void push_back(const T& element)
+            {
+                emplace_back(element);
+            }
+
+            /// \effects Same as `emplace_back(std::move(element))`.
+            void push_back(T&& element)
+            {
+                emplace_back(std::move(element));
+            }
+
+            /// \effects Appends copies of the elements in the range `[begin, end)`.
+            /// \returns An iterator to the first inserted element, or `end()` if the range was empty.
+            template <typename InputIt>
+            iterator append_range(InputIt begin, InputIt end)
+            {
+                auto index = size_;
+                append_range_impl(typename std::iterator_traits<InputIt>::iterator_category{},
+                                  begin, end);
+                return this->begin() + std::ptrdiff_t(index);
+            }
+
+            /// \effects Destroys all elements, but keeps the memory.
+            void clear() noexcept
+            {
+                destroy_range(begin(), end());
+                size_ = 0u;
+            }
+
+            /// \effects Destroys the last element.
+            void pop_back() noexcept
+            {
+                destroy_object(&back());
+                --size_;
+            }
+
+            /// \effects Destroys and removes the element at the given position,
+            /// moving the following elements to the front.
+            /// \returns An iterator after the element that was removed.
+            iterator erase(const_iterator pos) noexcept(std::is_nothrow_move_assignable<T>::value)
+            {
+                return erase_range(pos, std::next(pos));
+            }
+
+            /// \effects Destroys and removes all elements in the range `[begin, end)`,
+            /// moving the following elements to the front.
+            /// \returns An iterator after the last element that was removed.
+            iterator erase_range(const_iterator begin, const_iterator end) noexcept(
+                std::is_nothrow_move_assignable<T>::value)
+            {
+                auto mut_begin = data_ + (begin - cbegin());
+                auto mut_end   = data_ + (end - cbegin());
+
+                auto new_end = std::move(mut_end, data_ + size_, mut_begin);
+                destroy_range(new_end, data_ + size_);
+                size_ = std::uint32_t(new_end - data_);
+
+                return iterator(iterator_tag{}, mut_begin);
+            }
+
+        private:
+            array_view<const T> view() const noexcept
+            {
+                return array_view<const T>(data_, size_);
+            }
+
+            static void check_size(size_type size)
+            {
+                if (size > max_size())
+                    throw std::length_error("compact_array can't contain that many elements");
+            }
+
+            static void deallocate(T* data, std::uint32_t capacity) noexcept
+            {
+                typename Heap::handle_type handle;
+                if (data)
+                    Heap::deallocate(handle, memory_block(to_raw_pointer(data),
+                                                          capacity * sizeof(T)));
+            }
+
+            static size_type good_size(std::true_type, size_type size) noexcept
+            {
+                typename Heap::handle_type handle;
+                return size == 0u ? 0u : Heap::good_size(handle, size);
+            }
+            static size_type good_size(std::false_type, size_type size) noexcept
+            {
+                return size;
+            }
+
+            bool try_expand(std::true_type, size_type new_size) noexcept
+            {
+                typename Heap::handle_type handle;
+                auto block = memory_block(to_raw_pointer(data_), capacity_ * sizeof(T));
+                if (!Heap::try_expand(handle, block, new_size))
+                    return false;
+                set_capacity(block.size());
+                return true;
+            }
+            bool try_expand(std::false_type, size_type) noexcept
+            {
+                return false;
+            }
+
+            void reallocate(std::true_type, size_type new_size)
+            {
+                typename Heap::handle_type handle;
+                auto block = Heap::reallocate(handle,
+                                              memory_block(to_raw_pointer(data_),
+                                                           capacity_ * sizeof(T)),
+                                              new_size, alignof(T));
+                data_ = to_pointer<T>(block.begin());
+                set_capacity(block.size());
+            }
+            void reallocate(std::false_type, size_type new_size)
+            {
+                change_block(new_size);
+            }
+
+            void resize_block(size_type new_size)
+            {
+                // request only whole elements, deallocate() passes the capacity in bytes
+                new_size -= new_size % sizeof(T);
+                if (new_size == 0u)
+                {
+                    // only called if there are no elements
+                    deallocate(data_, capacity_);
+                    data_     = nullptr;
+                    capacity_ = 0u;
+                }
+                else if (!data_)
+                    change_block(new_size);
+                else if (new_size > capacity_ * sizeof(T)
+                         && try_expand(detail::heap_has_try_expand<Heap>{}, new_size))
+                    return;
+                else
+                    reallocate(detail::heap_can_reallocate<Heap, T>{}, new_size);
+            }
+
+            void change_block(size_type new_size)
+            {
+                typename Heap::handle_type handle;
+                auto new_block = Heap::allocate(handle, new_size, alignof(T));
+                try
+                {
+                    uninitialized_destructive_move(data_, data_ + size_, new_block);
+                }
+                catch (...)
+                {
+                    Heap::deallocate(handle, std::move(new_block));
+                    throw;
+                }
+
+                deallocate(data_, capacity_);
+                data_ = to_pointer<T>(new_block.begin());
+                set_capacity(new_block.size());
+            }
+
+            // the heap might return more memory than requested, but that can't be stored
+            void set_capacity(size_type bytes) noexcept
+            {
+                auto capacity = bytes / sizeof(T);
+                capacity_     = std::uint32_t(capacity < max_size() ? capacity : max_size());
+            }
+
+            template <typename InputIt>
+            void append_range_impl(std::input_iterator_tag, InputIt begin, InputIt end)
+            {
+                for (auto cur = begin; cur != end; ++cur)
+                    push_back(*cur);
+            }
+            template <typename ForwardIt>
+            void append_range_impl(std::forward_iterator_tag, ForwardIt begin, ForwardIt end)
+            {
+                auto needed = size_type(std::distance(begin, end));
+                reserve(size() + needed);
+                for (auto cur = begin; cur != end; ++cur)
+                {
+                    construct_object<T>(to_raw_pointer(data_ + size_), *cur);
+                    ++size_;
+                }
+            }
+
+            T*            data_;
+            std::uint32_t size_;
+            std::uint32_t capacity_;
+        };
+    } // namespace array
+} // namespace foonathan
+
+#endif // FOONATHAN_ARRAY_COMPACT_ARRAY_HPP_INCLUDED
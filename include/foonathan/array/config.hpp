@@ -27,6 +27,18 @@
 #define FOONATHAN_ARRAY_CONSTEXPR14
 #endif
 
+#ifndef FOONATHAN_ARRAY_HAS_CONSTEXPR_DEFAULT_INIT
+
+#if defined(__cpp_constexpr) && __cpp_constexpr >= 201907
+/// \exclude
+#define FOONATHAN_ARRAY_HAS_CONSTEXPR_DEFAULT_INIT 1
+#else
+/// \exclude
+#define FOONATHAN_ARRAY_HAS_CONSTEXPR_DEFAULT_INIT 0
+#endif
+
+#endif
+
 #ifndef FOONATHAN_ARRAY_HAS_BYTE
 
 #if defined(__cpp_lib_byte)
@@ -39,4 +51,31 @@
 
 #endif
 
+#ifndef FOONATHAN_ARRAY_HAS_SIZED_DEALLOCATION
+
+#if defined(__cpp_sized_deallocation)
+/// \exclude
+#define FOONATHAN_ARRAY_HAS_SIZED_DEALLOCATION 1
+#else
+/// \exclude
+#define FOONATHAN_ARRAY_HAS_SIZED_DEALLOCATION 0
+#endif
+
+#endif
+
+#ifndef FOONATHAN_ARRAY_NOINLINE
+
+#if defined(__GNUC__) || defined(__clang__)
+/// \exclude
+#define FOONATHAN_ARRAY_NOINLINE __attribute__((noinline))
+#elif defined(_MSC_VER)
+/// \exclude
+#define FOONATHAN_ARRAY_NOINLINE __declspec(noinline)
+#else
+/// \exclude
+#define FOONATHAN_ARRAY_NOINLINE
+#endif
+
+#endif
+
 #endif // FOONATHAN_ARRAY_CONFIG_HPP_INCLUDED
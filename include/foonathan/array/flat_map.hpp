@@ -234,6 +234,13 @@ namespace foonathan
             };
         } // namespace detail
 
+        /// How a bulk operation of an [array::flat_map]() handles equivalent keys in its input.
+        enum class duplicate_policy
+        {
+            keep_first, //< The first key and value are kept, like with individual insertion.
+            keep_last,  //< The last key and value are kept, like with individual assignment.
+        };
+
         /// A sorted map of keys to values.
         ///
         /// It is similar to [std::map]() or [std::multimap]() — depending on `AllowDuplicates`,
@@ -298,7 +305,7 @@ namespace foonathan
 
             /// \returns An array view to the mapped values.
             /// \group values
-            array_view<Value> values() noexcept
+            array_view<Value> values() noexcept(nothrow_unshare::value)
             {
                 return values_;
             }
@@ -308,7 +315,7 @@ namespace foonathan
                 return values_;
             }
 
-            iterator begin() noexcept
+            iterator begin() noexcept(nothrow_unshare::value)
             {
                 auto key_ptr   = iterator_to_pointer(keys_.begin());
                 auto value_ptr = iterator_to_pointer(values_.begin());
@@ -325,7 +332,7 @@ namespace foonathan
                 return const_iterator(typename const_iterator::private_key{}, key_ptr, value_ptr);
             }
 
-            iterator end() noexcept
+            iterator end() noexcept(nothrow_unshare::value)
             {
                 auto key_ptr   = iterator_to_pointer(keys_.end());
                 auto value_ptr = iterator_to_pointer(values_.end());
@@ -353,7 +360,7 @@ namespace foonathan
             /// \returns The key iterator corresponding to the given iterator.
             /// \requires The iterator must be an iterator in this map.
             /// \group value_iter
-            value_iterator value_iter(const_iterator iter) noexcept
+            value_iterator value_iter(const_iterator iter) noexcept(nothrow_unshare::value)
             {
                 return values_.begin() + index_of(iter);
             }
@@ -390,7 +397,7 @@ namespace foonathan
             }
 
             /// \group value_iter
-            value_iterator value_iter(key_const_iterator iter) noexcept
+            value_iterator value_iter(key_const_iterator iter) noexcept(nothrow_unshare::value)
             {
                 return values_.begin() + index_of(iter);
             }
@@ -403,7 +410,7 @@ namespace foonathan
             /// \returns The iterator corresponding to the given key or value iterator.
             /// \requires The iterator must be an iterator in this map.
             /// \group key_value_iter
-            iterator key_value_iter(key_const_iterator iter) noexcept
+            iterator key_value_iter(key_const_iterator iter) noexcept(nothrow_unshare::value)
             {
                 return iterator(typename iterator::private_key{}, iterator_to_pointer(iter),
                                 iterator_to_pointer(value_iter(iter)));
@@ -416,7 +423,7 @@ namespace foonathan
                                       iterator_to_pointer(value_iter(iter)));
             }
 
-            value_iterator value_begin() noexcept
+            value_iterator value_begin() noexcept(nothrow_unshare::value)
             {
                 return values_.begin();
             }
@@ -429,7 +436,7 @@ namespace foonathan
                 return values_.cbegin();
             }
 
-            value_iterator value_end() noexcept
+            value_iterator value_end() noexcept(nothrow_unshare::value)
             {
                 return values_.end();
             }
@@ -449,11 +456,10 @@ namespace foonathan
             }
 
             /// \group key_value_iter
-            iterator key_value_iter(value_const_iterator iter) noexcept
+            iterator key_value_iter(value_const_iterator iter) noexcept(nothrow_unshare::value)
             {
-                return iterator(typename iterator::private_key{},
-                                iterator_to_pointer(key_iter(iter)),
-                                const_cast<Value*>(iterator_to_pointer(iter)));
+                // go through the key iterator, the values might be copied if they were shared
+                return key_value_iter(key_iter(iter));
             }
             /// \group key_value_iter
             const_iterator key_value_iter(value_const_iterator iter) const noexcept
@@ -465,7 +471,7 @@ namespace foonathan
 
             /// \returns The key value pair with the minimal key.
             /// \group min
-            key_value_ref<Key, Value> min() noexcept
+            key_value_ref<Key, Value> min() noexcept(nothrow_unshare::value)
             {
                 return {keys_.min(), values_.front()};
             }
@@ -477,7 +483,7 @@ namespace foonathan
 
             /// \returns The key value pair with the maximal key.
             /// \group max
-            key_value_ref<Key, Value> max() noexcept
+            key_value_ref<Key, Value> max() noexcept(nothrow_unshare::value)
             {
                 return {keys_.max(), values_.back()};
             }
@@ -656,37 +662,54 @@ namespace foonathan
 
             /// \effects Inserts keys from the range `[key_begin, key_end)` combined with the matching values from `[value_begin, value_end)`.
             /// It will stop as soon as one range is exhausted.
+            /// If the map doesn't allow duplicates, existing keys and the first of equivalent keys in the range are kept,
+            /// like with individual insertion.
+            /// If an exception is thrown, nothing has changed,
+            /// unless `Key` or `Value` can only be moved with a move constructor that can throw.
+            /// \notes The range is sorted and then merged with the existing elements,
+            /// so it takes `O(n + m log m)` instead of `O(n * m)`, where `n` is `size()` and `m` the size of the range.
             template <typename KeyInputIt, typename ValueInputIt>
             void insert_range(KeyInputIt key_begin, KeyInputIt key_end, ValueInputIt value_begin,
                               ValueInputIt value_end)
             {
-                auto no_keys =
-                    range_size(typename std::iterator_traits<KeyInputIt>::iterator_category{},
-                               key_begin, key_end);
-                auto no_values =
-                    range_size(typename std::iterator_traits<KeyInputIt>::iterator_category{},
-                               value_begin, value_end);
+                auto input = make_bulk_input(key_begin, key_end, value_begin, value_end);
+                bulk_insert(input, duplicate_policy::keep_first, false);
+            }
 
-                auto min = std::min(no_keys, no_values);
-                reserve(size() + min);
+            /// \effects Inserts all elements in the range `[begin, end)` like `insert_range()`,
+            /// where the keys and values are given by `get<0>(*cur)` and `get<1>(*cur)`.
+            template <typename InputIt>
+            void insert_pair_range(InputIt begin, InputIt end)
+            {
+                auto input = make_bulk_input(begin, end);
+                bulk_insert(input, duplicate_policy::keep_first, false);
+            }
 
-                while (key_begin != key_end && value_begin != value_end)
-                {
-                    insert(*key_begin, *value_begin);
-                    ++key_begin;
-                    ++value_begin;
-                }
+            /// \effects Inserts keys from the range `[key_begin, key_end)` combined with the matching values from `[value_begin, value_end)`,
+            /// assigning the value of keys that are already in the map.
+            /// Of equivalent keys in the range, the last one is used, like with individual `insert_or_assign()`.
+            /// It has the same complexity and exception safety as `insert_range()`.
+            /// \requires The map must not allow duplicates.
+            template <typename KeyInputIt, typename ValueInputIt>
+            void insert_or_assign_range(KeyInputIt key_begin, KeyInputIt key_end,
+                                        ValueInputIt value_begin, ValueInputIt value_end)
+            {
+                static_assert(sizeof(KeyInputIt) == sizeof(KeyInputIt) && !AllowDuplicates,
+                              "insert_or_assign_range doesn't make sense on multi maps");
+                auto input = make_bulk_input(key_begin, key_end, value_begin, value_end);
+                bulk_insert(input, duplicate_policy::keep_last, true);
             }
 
-            /// \effects Inserts all elements in the range `[begin, end)` by calling `insert_pair(*cur)`.
+            /// \effects Same as `insert_or_assign_range()`,
+            /// but the keys and values are given by `get<0>(*cur)` and `get<1>(*cur)`.
+            /// \requires The map must not allow duplicates.
             template <typename InputIt>
-            void insert_pair_range(InputIt begin, InputIt end)
+            void insert_or_assign_pair_range(InputIt begin, InputIt end)
             {
-                reserve(size()
-                        + range_size(typename std::iterator_traits<InputIt>::iterator_category{},
-                                     begin, end));
-                for (auto cur = begin; cur != end; ++cur)
-                    insert_pair(*cur);
+                static_assert(sizeof(InputIt) == sizeof(InputIt) && !AllowDuplicates,
+                              "insert_or_assign_pair_range doesn't make sense on multi maps");
+                auto input = make_bulk_input(begin, end);
+                bulk_insert(input, duplicate_policy::keep_last, true);
             }
 
             /// \effects Destroys and removes all elements.
@@ -698,17 +721,19 @@ namespace foonathan
 
             /// \effects Destroys and removes the element at the given position.
             /// \returns An iterator after the element that was removed.
-            iterator erase(const_iterator pos) noexcept(std::is_nothrow_move_assignable<Key>::value)
+            iterator erase(const_iterator pos) noexcept(nothrow_erase::value)
             {
+                // compute both positions first, erasing the key might copy a shared block
+                auto value_pos = value_iter(pos);
                 auto key_after = keys_.erase(key_iter(pos));
-                values_.erase(value_iter(pos));
+                values_.erase(value_pos);
                 return key_value_iter(key_after);
             }
 
             /// \effects Destroys and removes all elements in the range `[begin, end)`.
             /// \returns An iterator after the last element that was removed.
-            iterator erase_range(const_iterator begin, const_iterator end) noexcept(
-                std::is_nothrow_move_assignable<Key>::value)
+            iterator erase_range(const_iterator begin,
+                                 const_iterator end) noexcept(nothrow_erase::value)
             {
                 auto value_begin = value_iter(begin);
                 auto value_end   = value_iter(end);
@@ -721,8 +746,7 @@ namespace foonathan
             /// \returns The number of elements that were removed, if it doesn't allow duplicates,
             /// whether or not any were removed otherwise.
             template <typename TransparentKey>
-            auto erase_all(const TransparentKey& key) noexcept(
-                std::is_nothrow_move_assignable<Key>::value) ->
+            auto erase_all(const TransparentKey& key) noexcept(nothrow_erase::value) ->
                 typename std::conditional<AllowDuplicates, size_type, bool>::type
             {
                 auto range = equal_range(key);
@@ -736,23 +760,27 @@ namespace foonathan
                 return count;
             }
 
-            /// \effects Conceptually the same as `flat_map<Key, Value> m; m.insert_range(key_begin, key_end, value_begin, value_end); *this = std::move(m);`
+            /// \effects Conceptually the same as `flat_map<Key, Value> m; m.insert_range(key_begin, key_end, value_begin, value_end); *this = std::move(m);`,
+            /// but the policy controls which of equivalent keys in the range is kept, if the map doesn't allow duplicates.
+            /// If an exception is thrown, nothing has changed.
             template <typename KeyInputIt, typename ValueInputIt>
             void assign_range(KeyInputIt key_begin, KeyInputIt key_end, ValueInputIt value_begin,
-                              ValueInputIt value_end)
+                              ValueInputIt value_end,
+                              duplicate_policy policy = duplicate_policy::keep_first)
             {
-                // TODO: exception safety
-                clear();
-                insert_range(key_begin, key_end, value_begin, value_end);
+                auto input = make_bulk_input(key_begin, key_end, value_begin, value_end);
+                bulk_assign(input, policy);
             }
 
-            /// \effects Conceptually the same as `flat_map<Key, Value> m; m.insert_pair_range(begin, end); *this = std::move(m);`
+            /// \effects Conceptually the same as `flat_map<Key, Value> m; m.insert_pair_range(begin, end); *this = std::move(m);`,
+            /// but the policy controls which of equivalent keys in the range is kept, if the map doesn't allow duplicates.
+            /// If an exception is thrown, nothing has changed.
             template <typename InputIt>
-            void assign_pair_range(InputIt begin, InputIt end)
+            void assign_pair_range(InputIt begin, InputIt end,
+                                   duplicate_policy policy = duplicate_policy::keep_first)
             {
-                // TODO: exception safety
-                clear();
-                insert_pair_range(begin, end);
+                auto input = make_bulk_input(begin, end);
+                bulk_assign(input, policy);
             }
 
             //=== lookup ===//
@@ -767,7 +795,7 @@ namespace foonathan
             /// \requires The key must be stored in the map.
             /// \group lookup
             template <typename TransparentKey>
-            Value& lookup(const TransparentKey& key) noexcept
+            Value& lookup(const TransparentKey& key) noexcept(nothrow_unshare::value)
             {
                 auto iter = find(key);
                 assert(iter != end());
@@ -786,7 +814,7 @@ namespace foonathan
             /// \returns A pointer to the value belonging to the given key, or `nullptr`, if there was none.
             /// \group try_lookup
             template <typename TransparentKey>
-            Value* try_lookup(const TransparentKey& key) noexcept
+            Value* try_lookup(const TransparentKey& key) noexcept(nothrow_unshare::value)
             {
                 auto iter = find(key);
                 if (iter == end())
@@ -809,7 +837,7 @@ namespace foonathan
             /// \returns An iterator to the given key-value-pair, or `end()` if the key is not in the map.
             /// \group find
             template <typename TransparentKey>
-            iterator find(const TransparentKey& key) noexcept
+            iterator find(const TransparentKey& key) noexcept(nothrow_unshare::value)
             {
                 return key_value_iter(keys_.find(key));
             }
@@ -831,7 +859,7 @@ namespace foonathan
             /// \returns Same as [array::lower_bound]() for the given `key`.
             /// \group lower_bound
             template <typename TransparentKey>
-            iterator lower_bound(const TransparentKey& key) noexcept
+            iterator lower_bound(const TransparentKey& key) noexcept(nothrow_unshare::value)
             {
                 return key_value_iter(keys_.lower_bound(key));
             }
@@ -845,7 +873,7 @@ namespace foonathan
             /// \returns Same as [array::upper_bound]() for the given `key`.
             /// \group upper_bound
             template <typename TransparentKey>
-            iterator upper_bound(const TransparentKey& key) noexcept
+            iterator upper_bound(const TransparentKey& key) noexcept(nothrow_unshare::value)
             {
                 return key_value_iter(keys_.upper_bound(key));
             }
@@ -859,7 +887,8 @@ namespace foonathan
             /// \returns Same as [array::equal_range]() for the given `key`.
             /// \group equal_range
             template <typename TransparentKey>
-            iter_pair<iterator> equal_range(const TransparentKey& key) noexcept
+            iter_pair<iterator> equal_range(const TransparentKey& key) noexcept(
+                nothrow_unshare::value)
             {
                 auto range = keys_.equal_range(key);
                 return {key_value_iter(range.begin()), key_value_iter(range.end())};
@@ -873,6 +902,12 @@ namespace foonathan
             }
 
         private:
+            using nothrow_unshare =
+                std::integral_constant<bool, !block_storage_copy_on_write<BlockStorage>::value>;
+            using nothrow_erase =
+                std::integral_constant<bool, nothrow_unshare::value
+                                                 && std::is_nothrow_move_assignable<Key>::value>;
+
             size_type index_of(key_const_iterator iter) const noexcept
             {
                 assert(iter >= keys_.begin() && iter <= keys_.end());
@@ -905,6 +940,195 @@ namespace foonathan
                 *iter = Value(std::forward<Args>(args)...);
             }
 
+            // the pairs of a bulk operation, stored as separate keys and values
+            // `order` contains the indices sorted by key, so the pairs don't need to be moved around
+            struct bulk_input
+            {
+                array<Key>       keys;
+                array<Value>     values;
+                array<size_type> order;
+            };
+
+            template <typename KeyInputIt, typename ValueInputIt>
+            static bulk_input make_bulk_input(KeyInputIt key_begin, KeyInputIt key_end,
+                                              ValueInputIt value_begin, ValueInputIt value_end)
+            {
+                auto no_keys =
+                    range_size(typename std::iterator_traits<KeyInputIt>::iterator_category{},
+                               key_begin, key_end);
+                auto no_values =
+                    range_size(typename std::iterator_traits<ValueInputIt>::iterator_category{},
+                               value_begin, value_end);
+
+                bulk_input input;
+                input.keys.reserve(std::min(no_keys, no_values));
+                input.values.reserve(std::min(no_keys, no_values));
+                for (; key_begin != key_end && value_begin != value_end; ++key_begin, ++value_begin)
+                {
+                    input.keys.emplace_back(*key_begin);
+                    input.values.emplace_back(*value_begin);
+                }
+                return input;
+            }
+
+            template <typename InputIt>
+            static bulk_input make_bulk_input(InputIt begin, InputIt end)
+            {
+                auto size = range_size(typename std::iterator_traits<InputIt>::iterator_category{},
+                                       begin, end);
+
+                bulk_input input;
+                input.keys.reserve(size);
+                input.values.reserve(size);
+                for (auto cur = begin; cur != end; ++cur)
+                {
+                    auto&& pair = *cur;
+
+                    using std::get;
+                    input.keys.emplace_back(get<0>(pair));
+                    input.values.emplace_back(get<1>(pair));
+                }
+                return input;
+            }
+
+            // sorts the order of the input, equivalent keys stay in input order
+            static void sort_bulk_input(bulk_input& input)
+            {
+                if (input.keys.size() < detail::radix_sort_threshold)
+                    sort_bulk_input(std::false_type{}, input);
+                else
+                    sort_bulk_input(key_compare_radix<Compare, Key>{}, input);
+            }
+            static void sort_bulk_input(std::true_type, bulk_input& input)
+            {
+                using radix_type = typename std::decay<decltype(
+                    key_compare_default::customize_for<Key>::radix_key(input.keys[0]))>::type;
+                using record = detail::radix_record<radix_type>;
+
+                // radix sort the keys together with their index, which is stable
+                array<record> records;
+                auto          view = records.append_uninitialized(input.keys.size());
+                for (auto i = size_type(0); i != view.size(); ++i)
+                    view[i] = record{key_compare_default::customize_for<Key>::radix_key(
+                                         input.keys[i]),
+                                     i};
+
+                array<record> buffer;
+                detail::radix_sort(view.data(), view.data_end(),
+                                   buffer.append_uninitialized(view.size()).data(),
+                                   [](const record& r) { return r.key; });
+
+                input.order.reserve(view.size());
+                for (auto& r : view)
+                    input.order.push_back(r.index);
+            }
+            static void sort_bulk_input(std::false_type, bulk_input& input)
+            {
+                input.order.reserve(input.keys.size());
+                for (auto i = size_type(0); i != input.keys.size(); ++i)
+                    input.order.push_back(i);
+
+                auto keys = iterator_to_pointer(input.keys.begin());
+                std::sort(input.order.begin(), input.order.end(),
+                          [&](size_type lhs, size_type rhs) {
+                              auto ordering = Compare::compare(keys[lhs], keys[rhs]);
+                              return ordering == key_ordering::less
+                                     || (ordering == key_ordering::equivalent && lhs < rhs);
+                          });
+            }
+
+            // existing elements are moved into the new arrays only if that can't throw,
+            // otherwise they're copied, so they're unchanged if an exception is thrown
+            using move_existing =
+                std::integral_constant<bool, std::is_nothrow_move_constructible<Key>::value
+                                                 && std::is_nothrow_move_constructible<Value>::value>;
+
+            template <typename T>
+            static auto transfer(T& obj) noexcept -> typename std::conditional<
+                move_existing::value || !std::is_copy_constructible<T>::value, T&&, const T&>::type
+            {
+                using result = typename std::conditional<move_existing::value
+                                                             || !std::is_copy_constructible<T>::value,
+                                                         T&&, const T&>::type;
+                return static_cast<result>(obj);
+            }
+
+            // merges the input with the existing elements into new arrays,
+            // if replace is true, the value of an existing key is replaced by the one of the input
+            void bulk_insert(bulk_input& input, duplicate_policy policy, bool replace)
+            {
+                sort_bulk_input(input);
+
+                auto& old_keys   = keys_.array_;
+                auto  old_size   = size();
+                auto  new_keys   = array<Key, BlockStorage>(old_keys.block_storage_args());
+                auto  new_values = value_storage(values_.block_storage_args());
+                new_keys.reserve(old_size + input.keys.size());
+                new_values.reserve(old_size + input.keys.size());
+
+                auto take_old = [&](size_type i) {
+                    new_keys.emplace_back(transfer(old_keys[i]));
+                    new_values.emplace_back(transfer(values_[i]));
+                };
+                // in a multi map, the new keys are inserted after the equivalent old ones
+                auto old_first = [](const Key& old_key, const Key& new_key) {
+                    auto ordering = Compare::compare(old_key, new_key);
+                    return ordering == key_ordering::less
+                           || (AllowDuplicates && ordering == key_ordering::equivalent);
+                };
+
+                auto old = size_type(0);
+                for (auto cur = size_type(0); cur != input.order.size();)
+                {
+                    // the run of equivalent keys in the input, only one of them is used
+                    auto run_end = cur + 1u;
+                    while (!AllowDuplicates && run_end != input.order.size()
+                           && Compare::compare(input.keys[input.order[cur]],
+                                               input.keys[input.order[run_end]])
+                                  == key_ordering::equivalent)
+                        ++run_end;
+                    auto index = policy == duplicate_policy::keep_first ? input.order[cur]
+                                                                        : input.order[run_end - 1u];
+                    cur = run_end;
+
+                    auto& key = input.keys[index];
+                    while (old != old_size && old_first(old_keys[old], key))
+                        take_old(old++);
+
+                    if (!AllowDuplicates && old != old_size
+                        && Compare::compare(old_keys[old], key) == key_ordering::equivalent)
+                    {
+                        // key is already in the map, keep the existing key
+                        if (replace)
+                        {
+                            new_keys.emplace_back(transfer(old_keys[old]));
+                            new_values.emplace_back(std::move(input.values[index]));
+                            ++old;
+                        }
+                        else
+                            take_old(old++);
+                    }
+                    else
+                    {
+                        new_keys.emplace_back(std::move(key));
+                        new_values.emplace_back(std::move(input.values[index]));
+                    }
+                }
+                while (old != old_size)
+                    take_old(old++);
+
+                swap(old_keys, new_keys);
+                swap(values_, new_values);
+            }
+
+            // replaces the elements by the input
+            void bulk_assign(bulk_input& input, duplicate_policy policy)
+            {
+                flat_map result(values_.block_storage_args());
+                result.bulk_insert(input, policy, false);
+                swap(*this, result);
+            }
+
             template <typename InputIt>
             static size_type range_size(std::input_iterator_tag, InputIt, InputIt)
             {
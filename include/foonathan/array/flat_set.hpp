@@ -23,7 +23,13 @@ namespace foonathan
             mutable Value value;
 
             /// \effects Creates it by constructing the key from the given key and the value from the arguments.
-            template <typename TransparentKey, typename... ValueArgs>
+            /// \notes This constructor does not participate in overload resolution for a single `key_value_pair`,
+            /// so it doesn't hijack the copy constructor.
+            template <typename TransparentKey, typename... ValueArgs,
+                      typename = typename std::enable_if<
+                          sizeof...(ValueArgs) != 0u
+                          || !std::is_same<typename std::decay<TransparentKey>::type,
+                                           key_value_pair>::value>::type>
             explicit key_value_pair(TransparentKey&& key, ValueArgs&&... args)
             : key(std::forward<TransparentKey>(key)), value(std::forward<ValueArgs>(args)...)
             {
@@ -42,6 +48,20 @@ namespace foonathan
             {
                 return key_compare_default::compare(pair.key, t);
             }
+
+            static auto compare(const key_value_pair<Key, Value>& lhs,
+                                const key_value_pair<Key, Value>& rhs) noexcept
+                -> decltype(key_compare_default::compare(lhs.key, rhs.key))
+            {
+                return key_compare_default::compare(lhs.key, rhs.key);
+            }
+
+            template <typename K = Key>
+            static auto radix_key(const key_value_pair<K, Value>& pair) noexcept
+                -> decltype(key_compare_default::customize_for<K>::radix_key(pair.key))
+            {
+                return key_compare_default::customize_for<K>::radix_key(pair.key);
+            }
         };
 
         namespace detail
@@ -88,6 +108,10 @@ namespace foonathan
         ///
         /// \notes When you have a `flat_set<key_value_pair<Key, Value>>`,
         /// you have something similar to [array::flat_map]() but where the keys and values are stored together.
+        template <typename Key, typename Value, class Compare, class BlockStorage,
+                  bool AllowDuplicates>
+        class flat_map;
+
         template <typename Key, typename Compare = key_compare_default,
                   class BlockStorage = block_storage_default, bool AllowDuplicates = false>
         class flat_set
@@ -159,7 +183,7 @@ namespace foonathan
             }
 
             /// \returns An input view to the elements.
-            operator input_view<Key, BlockStorage>() && noexcept
+            operator input_view<Key, BlockStorage>() && noexcept(nothrow_unshare::value)
             {
                 return std::move(array_).operator input_view<Key, BlockStorage>();
             }
@@ -308,11 +332,28 @@ namespace foonathan
             }
 
             /// \effects Inserts all elements in the range `[begin, end)`.
+            /// If it doesn't allow duplicates, the first of multiple equivalent keys is kept,
+            /// like with individual insertion.
+            /// If an exception is thrown while copying or sorting the new elements, nothing has changed,
+            /// if it is thrown while merging them, it will be empty.
+            /// \notes The elements are appended, sorted and then merged with the existing ones,
+            /// so it takes `O(n + m log m)` instead of `O(n * m)`, where `n` is `size()` and `m` the size of the range.
+            /// The merge uses `std::inplace_merge()`, which allocates a temporary buffer if it can.
             template <typename InputIt>
             void insert_range(InputIt begin, InputIt end)
             {
-                insert_range_impl(typename std::iterator_traits<InputIt>::iterator_category{},
-                                  begin, end);
+                auto old_size = array_.size();
+                try
+                {
+                    array_.append_range(begin, end);
+                }
+                catch (...)
+                {
+                    // the input iterator version can leave some of the new elements
+                    array_.erase_range(array_.begin() + std::ptrdiff_t(old_size), array_.end());
+                    throw;
+                }
+                merge_back(old_size);
             }
 
             /// \effects Destroys and removes all elements.
@@ -323,15 +364,14 @@ namespace foonathan
 
             /// \effects Destroys and removes the element at the given position.
             /// \returns An iterator after the element that was removed.
-            iterator erase(iterator pos) noexcept(std::is_nothrow_move_assignable<Key>::value)
+            iterator erase(iterator pos) noexcept(nothrow_erase::value)
             {
                 return convert_iterator(array_.erase(convert_iterator(pos)));
             }
 
             /// \effects Destroys and removes all elements in the range `[begin, end)`.
             /// \returns An iterator after the last element that was removed.
-            iterator erase_range(iterator begin,
-                                 iterator end) noexcept(std::is_nothrow_move_assignable<Key>::value)
+            iterator erase_range(iterator begin, iterator end) noexcept(nothrow_erase::value)
             {
                 return convert_iterator(
                     array_.erase_range(convert_iterator(begin), convert_iterator(end)));
@@ -341,8 +381,7 @@ namespace foonathan
             /// \returns The number of elements that were removed, if it doesn't allow duplicates,
             /// whether or not any were removed otherwise.
             template <typename TransparentKey>
-            auto erase_all(const TransparentKey& key) noexcept(
-                std::is_nothrow_move_assignable<Key>::value) ->
+            auto erase_all(const TransparentKey& key) noexcept(nothrow_erase::value) ->
                 typename std::conditional<AllowDuplicates, size_type, bool>::type
             {
                 auto range = equal_range(key);
@@ -357,58 +396,38 @@ namespace foonathan
             }
 
             /// \effects Conceptually the same as `*this = flat_set<Key>(input)`.
+            /// If an exception is thrown, it will be empty.
+            /// \notes The elements are stolen, moved or copied into the set and then sorted,
+            /// which is linear if they're already sorted or sorted in reverse.
             void assign(input_view<Key, BlockStorage>&& input)
             {
-                if (input.will_steal_memory())
+                try
                 {
-                    // steal memory, then sort + unique is probably going to be faster
-                    // than the individual insert done below
-
                     array_.assign(std::move(input));
-
-                    std::sort(array_.begin(), array_.end(), [&](const Key& lhs, const Key& rhs) {
-                        return Compare::compare(lhs, rhs) == key_ordering::less;
-                    });
-
-                    if (!AllowDuplicates)
-                    {
-                        auto new_end = std::unique(array_.begin(), array_.end(),
-                                                   [&](const Key& lhs, const Key& rhs) {
-                                                       return Compare::compare(lhs, rhs)
-                                                              == key_ordering::equivalent;
-                                                   });
-                        array_.erase_range(new_end, array_.end());
-                    }
                 }
-                else
+                catch (...)
                 {
                     array_.clear();
-                    array_.reserve(input.size());
-
-                    // insert all elements individually
-                    for (auto& element : input.view())
-                    {
-                        if (input.will_copy())
-                            insert(element);
-                        else
-                        {
-                            // safe, according to precondition of input view,
-                            // we're allowed to move them
-                            auto& non_const = const_cast<Key&>(element);
-                            insert(std::move(non_const));
-                        }
-                    }
+                    throw;
                 }
+                merge_back(0u);
             }
 
             /// \effects Conceptually the same as `flat_set<Key> s; s.insert_range(begin, end); *this = std::move(s);`
+            /// If an exception is thrown, it will be empty.
             template <typename InputIt>
             void assign_range(InputIt begin, InputIt end)
             {
-                array_.assign_range(begin, end);
-                std::sort(array_.begin(), array_.end(), [&](const Key& lhs, const Key& rhs) {
-                    return Compare::compare(lhs, rhs) == key_ordering::less;
-                });
+                try
+                {
+                    array_.assign_range(begin, end);
+                }
+                catch (...)
+                {
+                    array_.clear();
+                    throw;
+                }
+                merge_back(0u);
             }
 
             //=== lookup ===//
@@ -485,6 +504,12 @@ namespace foonathan
             }
 
         private:
+            using nothrow_unshare =
+                std::integral_constant<bool, !block_storage_copy_on_write<BlockStorage>::value>;
+            using nothrow_erase =
+                std::integral_constant<bool, nothrow_unshare::value
+                                                 && std::is_nothrow_move_assignable<Key>::value>;
+
             static iterator convert_iterator(
                 typename array<Key, BlockStorage>::const_iterator iter) noexcept
             {
@@ -499,22 +524,106 @@ namespace foonathan
                 return pointer_to_iterator<typename array<Key, BlockStorage>::const_iterator>(ptr);
             }
 
-            template <typename InputIt>
-            void insert_range_impl(std::input_iterator_tag, InputIt begin, InputIt end)
+            // sorts the range, equivalent keys stay in their order
+            // it is linear if the range is already sorted or strictly sorted in reverse
+            template <typename Iter>
+            static void sort_range(Iter begin, Iter end)
+            {
+                auto less = [](const Key& lhs, const Key& rhs) {
+                    return Compare::compare(lhs, rhs) == key_ordering::less;
+                };
+
+                if (std::is_sorted(begin, end, less))
+                    return;
+
+                auto descending =
+                    std::adjacent_find(begin, end, [](const Key& lhs, const Key& rhs) {
+                        return Compare::compare(lhs, rhs) != key_ordering::greater;
+                    }) == end;
+                if (descending)
+                    std::reverse(begin, end);
+                else if (size_type(end - begin) < detail::radix_sort_threshold)
+                    std::stable_sort(begin, end, less);
+                else
+                    sort_unsorted(radix_sortable{}, begin, end);
+            }
+
+            // keys that are trivially copyable can be radix sorted directly
+            using radix_sortable =
+                std::integral_constant<bool, key_compare_radix<Compare, Key>::value
+                                                 && std::is_trivially_copyable<Key>::value>;
+
+            template <typename Iter>
+            static void sort_unsorted(std::true_type, Iter begin, Iter end)
             {
-                for (auto cur = begin; cur != end; ++cur)
-                    insert(*cur);
+                // raw memory, so the key doesn't need to be default constructible
+                using raw_key = typename std::aligned_storage<sizeof(Key), alignof(Key)>::type;
+                array<raw_key> buffer;
+                auto           buffer_view = buffer.append_uninitialized(size_type(end - begin));
+                detail::radix_sort(iterator_to_pointer(begin), iterator_to_pointer(end),
+                                   reinterpret_cast<Key*>(buffer_view.data()), [](const Key& key) {
+                                       return key_compare_default::customize_for<Key>::radix_key(
+                                           key);
+                                   });
             }
-            template <typename ForwardIt>
-            void insert_range_impl(std::forward_iterator_tag, ForwardIt begin, ForwardIt end)
+            template <typename Iter>
+            static void sort_unsorted(std::false_type, Iter begin, Iter end)
             {
-                auto size = std::distance(begin, end);
-                array_.reserve(array_.size() + size_type(size));
+                std::stable_sort(begin, end, [](const Key& lhs, const Key& rhs) {
+                    return Compare::compare(lhs, rhs) == key_ordering::less;
+                });
+            }
 
-                insert_range_impl(std::input_iterator_tag{}, begin, end);
+            // merges the unsorted elements starting at the given index into the sorted ones before
+            // if an exception is thrown while sorting, the new elements are removed again,
+            // if it is thrown while merging, the order is lost and all elements are removed
+            void merge_back(size_type index)
+            {
+                auto less = [](const Key& lhs, const Key& rhs) {
+                    return Compare::compare(lhs, rhs) == key_ordering::less;
+                };
+
+                auto middle = array_.begin() + std::ptrdiff_t(index);
+                try
+                {
+                    sort_range(middle, array_.end());
+                }
+                catch (...)
+                {
+                    array_.erase_range(middle, array_.end());
+                    throw;
+                }
+                if (middle == array_.end())
+                    return;
+
+                // the elements before the first new one are already in place
+                auto first = std::lower_bound(array_.begin(), middle, *middle, less);
+                try
+                {
+                    std::inplace_merge(first, middle, array_.end(), less);
+
+                    if (!AllowDuplicates)
+                    {
+                        // the existing key is merged in front of the new ones, so it is kept
+                        auto new_end =
+                            std::unique(first, array_.end(), [](const Key& lhs, const Key& rhs) {
+                                return Compare::compare(lhs, rhs) == key_ordering::equivalent;
+                            });
+                        array_.erase_range(new_end, array_.end());
+                    }
+                }
+                catch (...)
+                {
+                    array_.clear();
+                    throw;
+                }
             }
 
             array<Key, BlockStorage> array_;
+
+            // for the bulk operations, which assign already sorted keys
+            template <typename, typename, class, class, bool>
+            friend class flat_map;
         };
 
         /// Convenience typedef for an [array::flat_set]() that allows duplicates.
@@ -123,15 +123,77 @@ namespace foonathan
             }
 
             /// \returns `size_needed`, i.e. shrink to the minimum.
-            static size_type shrink_size(size_type cur_size, size_type size_needed) noexcept
+            static size_type shrink_size(size_type cur_size, size_type size_needed,
+                                         size_type max_size) noexcept
             {
                 (void)cur_size;
+                (void)max_size;
                 return size_needed;
             }
         };
 
         /// The default growth policy.
         using default_growth = factor_growth<2>;
+
+        /// A growth policy that grows like `GrowthPolicy`, but only shrinks with some hysteresis.
+        ///
+        /// It only shrinks if less than `1 / ShrinkDivisor` of the current size is needed,
+        /// and then it shrinks to `SlackNumerator / SlackDenominator` times the size needed.
+        /// This prevents repeated growing and shrinking around a boundary.
+        template <class GrowthPolicy = default_growth, unsigned ShrinkDivisor = 4,
+                  unsigned SlackNumerator = 3, unsigned SlackDenominator = 2>
+        struct hysteresis_growth
+        {
+            static_assert(ShrinkDivisor > 1, "does not actually shrink the size");
+            static_assert(SlackNumerator >= SlackDenominator, "slack must not be less than 1");
+            static_assert(SlackNumerator < ShrinkDivisor * SlackDenominator,
+                          "shrinking would not reduce the size");
+
+            /// \returns The same as `GrowthPolicy`.
+            static size_type growth_size(size_type cur_size, size_type additional_needed,
+                                         size_type max_size) noexcept
+            {
+                return GrowthPolicy::growth_size(cur_size, additional_needed, max_size);
+            }
+
+            /// \returns `cur_size` if at least `1 / ShrinkDivisor` of it is needed,
+            /// `size_needed` times the slack otherwise.
+            static size_type shrink_size(size_type cur_size, size_type size_needed,
+                                         size_type max_size) noexcept
+            {
+                if (size_needed * ShrinkDivisor >= cur_size)
+                    return cur_size;
+
+                auto slack  = size_needed / SlackDenominator * (SlackNumerator - SlackDenominator);
+                auto result = size_needed + slack;
+                return result < max_size ? result : max_size;
+            }
+        };
+
+        /// A growth policy that is the same as `GrowthPolicy`,
+        /// but requests that containers shrink automatically after removing elements.
+        ///
+        /// Use it together with [array::hysteresis_growth]() to prevent shrinking after every removal.
+        template <class GrowthPolicy>
+        struct auto_shrink_growth : GrowthPolicy
+        {
+            using auto_shrink = std::true_type;
+        };
+
+        namespace detail
+        {
+            template <class GrowthPolicy, typename = void>
+            struct growth_auto_shrink : std::false_type
+            {
+            };
+
+            template <class GrowthPolicy>
+            struct growth_auto_shrink<GrowthPolicy,
+                                      decltype(void(GrowthPolicy::auto_shrink::value))>
+            : GrowthPolicy::auto_shrink
+            {
+            };
+        } // namespace detail
     } // namespace array
 } // namespace foonathan
 
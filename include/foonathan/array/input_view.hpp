@@ -94,7 +94,9 @@ namespace foonathan
             template <typename Block,
                       typename = typename std::enable_if<!std::is_reference<Block>::value
                                                          && can_steal<Block>::value>::type>
-            input_view(Block&& input) noexcept : input_view(std::move(input).operator input_view())
+            input_view(Block&& input) noexcept(
+                noexcept(std::declval<Block>().operator input_view()))
+            : input_view(std::move(input).operator input_view())
             {
             }
 
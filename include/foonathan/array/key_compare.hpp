@@ -5,7 +5,11 @@
 #ifndef FOONATHAN_ARRAY_KEY_COMPARE_HPP_INCLUDED
 #define FOONATHAN_ARRAY_KEY_COMPARE_HPP_INCLUDED
 
+#include <climits>
+#include <cstdint>
+#include <cstring>
 #include <functional>
+#include <limits>
 #include <type_traits>
 
 #include <foonathan/array/array_view.hpp>
@@ -86,6 +90,51 @@ namespace foonathan
                 else
                     return key_ordering::equivalent;
             }
+
+            // radix keys, unsigned integers with the same ordering as the comparison
+            template <typename T>
+            auto radix_key(T k) noexcept ->
+                typename std::enable_if<std::is_integral<T>::value && !std::is_same<T, bool>::value,
+                                        std::make_unsigned<T>>::type::type
+            {
+                // flip the sign bit, so negative numbers are sorted before positive ones
+                using type = typename std::make_unsigned<T>::type;
+                return std::is_signed<T>::value
+                           ? type(type(k) ^ (type(1) << (sizeof(T) * CHAR_BIT - 1u)))
+                           : type(k);
+            }
+
+            template <typename T, typename Bits>
+            Bits float_radix_key(T k) noexcept
+            {
+                static_assert(sizeof(T) == sizeof(Bits), "invalid bits type");
+                if (k == T(0))
+                    k = T(0); // -0.0 is equivalent to 0.0
+
+                Bits bits;
+                std::memcpy(&bits, &k, sizeof(T));
+
+                // negative numbers are sorted in reverse, so flip all bits,
+                // otherwise only the sign bit
+                auto sign_bit = Bits(1) << (sizeof(T) * CHAR_BIT - 1u);
+                return (bits & sign_bit) != 0u ? Bits(~bits) : Bits(bits | sign_bit);
+            }
+
+            template <typename T>
+            auto radix_key(T k) noexcept -> typename std::enable_if<
+                std::is_same<T, float>::value && std::numeric_limits<T>::is_iec559,
+                std::uint32_t>::type
+            {
+                return float_radix_key<T, std::uint32_t>(k);
+            }
+
+            template <typename T>
+            auto radix_key(T k) noexcept -> typename std::enable_if<
+                std::is_same<T, double>::value && std::numeric_limits<T>::is_iec559,
+                std::uint64_t>::type
+            {
+                return float_radix_key<T, std::uint64_t>(k);
+            }
         } // namespace comp_detail
 
         /// The default comparison of keys sorting them in increasing order.
@@ -111,6 +160,16 @@ namespace foonathan
                 {
                     return comp_detail::compare_impl(comp_detail::pointer{}, k, t);
                 }
+
+                /// \returns An unsigned integer that is sorted the same way as the key,
+                /// used to sort with a radix sort.
+                /// \notes It is only available for integer and floating point keys.
+                /// A specialization for a user-defined type can provide it as well to opt in.
+                template <typename K = Key>
+                static auto radix_key(const K& k) noexcept -> decltype(comp_detail::radix_key(k))
+                {
+                    return comp_detail::radix_key(k);
+                }
             };
 
             template <typename Key, typename TransparentKey>
@@ -121,6 +180,98 @@ namespace foonathan
             }
         };
 
+        namespace detail
+        {
+            template <class Compare, typename Key, typename = void>
+            struct key_compare_radix_impl : std::false_type
+            {
+            };
+
+            template <typename Key>
+            struct key_compare_radix_impl<
+                key_compare_default, Key,
+                decltype(void(key_compare_default::customize_for<Key>::radix_key(
+                    std::declval<const Key&>())))>
+            : std::is_unsigned<decltype(
+                  key_compare_default::customize_for<Key>::radix_key(std::declval<const Key&>()))>
+            {
+            };
+
+            // below that a comparison sort is faster
+            constexpr size_type radix_sort_threshold = 256u;
+
+            // a radix key together with the index of the element it belongs to
+            template <typename RadixKey>
+            struct radix_record
+            {
+                RadixKey  key;
+                size_type index;
+            };
+
+            // stable LSD radix sort, one byte at a time, using the buffer of the same size
+            // the buffer can be uninitialized, the elements are copied into it as bytes
+            template <typename T, typename GetKey>
+            void radix_sort(T* begin, T* end, T* buffer, GetKey get_key) noexcept
+            {
+                static_assert(std::is_trivially_copyable<T>::value, "elements are copied as bytes");
+                using key_type = typename std::decay<decltype(get_key(*begin))>::type;
+                constexpr auto no_passes = sizeof(key_type);
+
+                auto size = size_type(end - begin);
+                if (size == 0u)
+                    return;
+
+                // count the digits of all passes at once
+                size_type counts[no_passes][256] = {};
+                for (auto cur = begin; cur != end; ++cur)
+                {
+                    auto key = get_key(*cur);
+                    for (auto pass = 0u; pass != no_passes; ++pass)
+                        ++counts[pass][(key >> (pass * CHAR_BIT)) & 0xFFu];
+                }
+
+                auto src = begin;
+                auto dst = buffer;
+                for (auto pass = 0u; pass != no_passes; ++pass)
+                {
+                    auto& count = counts[pass];
+                    if (count[(get_key(*src) >> (pass * CHAR_BIT)) & 0xFFu] == size)
+                        // all elements have the same digit
+                        continue;
+
+                    size_type offsets[256];
+                    auto      offset = size_type(0);
+                    for (auto digit = 0u; digit != 256u; ++digit)
+                    {
+                        offsets[digit] = offset;
+                        offset += count[digit];
+                    }
+
+                    for (auto cur = src; cur != src + size; ++cur)
+                    {
+                        auto pos = offsets[(get_key(*cur) >> (pass * CHAR_BIT)) & 0xFFu]++;
+                        std::memcpy(static_cast<void*>(dst + pos), static_cast<const void*>(cur),
+                                    sizeof(T));
+                    }
+                    std::swap(src, dst);
+                }
+
+                if (src != begin)
+                    std::memcpy(static_cast<void*>(begin), static_cast<const void*>(src),
+                                size * sizeof(T));
+            }
+        } // namespace detail
+
+        /// `std::true_type` if keys of type `Key` can be sorted with a radix sort according to `Compare`, `std::false_type` otherwise.
+        ///
+        /// This is the case if `Compare` is [array::key_compare_default]()
+        /// and `key_compare_default::customize_for<Key>` provides a `radix_key(const Key&)` function.
+        /// It must return an unsigned integer, where the order of the integers is the order of the keys.
+        /// It is provided for integer and floating point keys.
+        template <class Compare, typename Key>
+        using key_compare_radix =
+            std::integral_constant<bool, detail::key_compare_radix_impl<Compare, Key>::value>;
+
         /// A lightweight view into a sorted array.
         ///
         /// This is an [array::array_view]() where the elements are sorted according to `Compare`.
@@ -32,9 +32,15 @@ namespace foonathan
 
             constexpr pointer_iterator() noexcept : ptr_(nullptr) {}
 
-            constexpr pointer_iterator(
-                const pointer_iterator<Tag, typename std::remove_const<T>::type>&
-                    non_const) noexcept
+            constexpr pointer_iterator(const pointer_iterator&) noexcept = default;
+            FOONATHAN_ARRAY_CONSTEXPR14 pointer_iterator& operator=(const pointer_iterator&) noexcept =
+                default;
+
+            /// \effects Converts a non-`const` iterator into a `const` one.
+            /// \notes This constructor does not participate in overload resolution unless `T` is `const U`.
+            template <typename U,
+                      typename = typename std::enable_if<std::is_same<const U, T>::value>::type>
+            constexpr pointer_iterator(const pointer_iterator<Tag, U>& non_const) noexcept
             : ptr_(non_const.operator->())
             {
             }
@@ -147,7 +153,7 @@ namespace foonathan
             }
 
         private:
-            explicit pointer_iterator(pointer ptr) : ptr_(ptr) {}
+            explicit constexpr pointer_iterator(pointer ptr) : ptr_(ptr) {}
 
             T* ptr_;
 
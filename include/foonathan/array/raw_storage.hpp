@@ -8,8 +8,10 @@
 #include <cassert>
 #include <cstring>
 #include <iterator>
+#include <memory>
 #include <new>
 #include <type_traits>
+#include <utility>
 
 #include <foonathan/array/contiguous_iterator.hpp>
 #include <foonathan/array/memory_block.hpp>
@@ -18,6 +20,60 @@ namespace foonathan
 {
     namespace array
     {
+        /// Type trait to check whether a type is trivially relocatable.
+        ///
+        /// A type is trivially relocatable if moving an object to a new location and destroying the old one
+        /// is equivalent to copying the bytes and forgetting about the old object.
+        /// Then objects can be moved around using `std::memcpy()` and `std::memmove()`.
+        ///
+        /// By default, this is the case for trivially copyable types.
+        /// Custom types may specialize this trait in order to mark themselves as trivially relocatable,
+        /// this is the case for most types that do not store a pointer to themselves.
+        template <typename T>
+        struct is_trivially_relocatable : std::is_trivially_copyable<T>
+        {
+        };
+
+        /// Specialization to mark [std::unique_ptr]() with the default deleter as trivially relocatable.
+        template <typename T, typename U>
+        struct is_trivially_relocatable<std::unique_ptr<T, std::default_delete<U>>> : std::true_type
+        {
+        };
+
+        /// Specialization to mark [std::shared_ptr]() as trivially relocatable.
+        template <typename T>
+        struct is_trivially_relocatable<std::shared_ptr<T>> : std::true_type
+        {
+        };
+
+        /// Specialization to mark [std::weak_ptr]() as trivially relocatable.
+        template <typename T>
+        struct is_trivially_relocatable<std::weak_ptr<T>> : std::true_type
+        {
+        };
+
+        /// Specialization to mark [std::pair]() as trivially relocatable if both members are.
+        template <typename T, typename U>
+        struct is_trivially_relocatable<std::pair<T, U>>
+        : std::integral_constant<bool, is_trivially_relocatable<T>::value
+                                           && is_trivially_relocatable<U>::value>
+        {
+        };
+
+        /// Type trait to check whether value initialization of a type sets all bytes to zero.
+        ///
+        /// Then value initialized objects can be created by using memory that is already zeroed,
+        /// e.g. fresh pages from the operating system.
+        ///
+        /// By default, this is the case for scalar types except pointers to members.
+        /// Custom trivial types may specialize this trait if all their members are.
+        template <typename T>
+        struct is_trivially_value_initializable
+        : std::integral_constant<bool,
+                                 std::is_scalar<T>::value && !std::is_member_pointer<T>::value>
+        {
+        };
+
         /// \effects Creates a new object at the given location using default initialization.
         /// \returns A pointer to the newly created object.
         /// \notes Default initialization may not do any initialization at all.
@@ -213,15 +269,38 @@ namespace foonathan
             raw_pointer cur_end_, max_end_;
         };
 
+        namespace detail
+        {
+            template <typename T>
+            raw_pointer uninitialized_default_construct_impl(std::true_type,
+                                                             const memory_block& block,
+                                                             size_type           n) noexcept
+            {
+                // default initialization doesn't do anything
+                assert(block.size() >= n * sizeof(T));
+                return block.begin() + n * sizeof(T);
+            }
+
+            template <typename T>
+            raw_pointer uninitialized_default_construct_impl(std::false_type,
+                                                             const memory_block& block,
+                                                             size_type           n)
+            {
+                partially_constructed_range<T> range(block);
+                for (auto i = size_type(0); i != n; ++i)
+                    range.default_construct_object();
+                return std::move(range).release();
+            }
+        } // namespace detail
+
         /// \effects Creates `n` objects of type `T` in the memory block using [array::default_construct_object]().
         /// \returns A pointer after the last created object.
+        /// \notes If `T` is trivially default constructible, the memory isn't touched at all.
         template <typename T>
         raw_pointer uninitialized_default_construct(const memory_block& block, size_type n)
         {
-            partially_constructed_range<T> range(block);
-            for (auto i = size_type(0); i != n; ++i)
-                range.default_construct_object();
-            return std::move(range).release();
+            return detail::uninitialized_default_construct_impl<T>(
+                std::is_trivially_default_constructible<T>{}, block, n);
         }
 
         /// \effects Creates `n` objects of type `T` in the memory block using [array::value_construct_object]().
@@ -262,7 +341,8 @@ namespace foonathan
                 auto no_elements = std::size_t(end - begin);
                 auto size        = no_elements * sizeof(T);
                 assert(block.size() >= size);
-                std::memcpy(to_void_pointer(block.begin()), iterator_to_pointer(begin), size);
+                if (size != 0u)
+                    std::memcpy(to_void_pointer(block.begin()), iterator_to_pointer(begin), size);
                 return block.begin() + size;
             }
 
@@ -347,17 +427,119 @@ namespace foonathan
             return std::move(range).release();
         }
 
+        namespace detail
+        {
+            template <typename InputIter, typename T>
+            struct can_relocate
+            : std::integral_constant<bool, is_contiguous_iterator<InputIter>::value
+                                               && is_trivially_relocatable<T>::value>
+            {
+            };
+
+            template <typename T, typename ContIter>
+            raw_pointer uninitialized_destructive_move_impl(std::true_type, ContIter begin,
+                                                            ContIter end,
+                                                            const memory_block& block) noexcept
+            {
+                // copy the bytes, the objects at the old location are then gone
+                auto no_elements = std::size_t(end - begin);
+                auto size        = no_elements * sizeof(T);
+                assert(block.size() >= size);
+                if (size != 0u)
+                    std::memcpy(to_void_pointer(block.begin()),
+                                static_cast<const void*>(iterator_to_pointer(begin)), size);
+                return block.begin() + size;
+            }
+
+            template <typename T, typename FwdIter>
+            raw_pointer uninitialized_destructive_move_impl(std::false_type, FwdIter begin,
+                                                            FwdIter end, const memory_block& block)
+            {
+                auto result = uninitialized_move_if_noexcept(begin, end, block);
+                destroy_range(begin, end);
+                return result;
+            }
+
+            // relocates the objects in [begin, end) to dest, the ranges may overlap
+            // afterwards the objects live at dest and the old location no longer contains objects
+            template <typename T>
+            T* relocate_overlapping(T* begin, T* end, T* dest) noexcept
+            {
+                static_assert(is_trivially_relocatable<T>::value, "type cannot be relocated");
+                auto no_elements = std::size_t(end - begin);
+                std::memmove(static_cast<void*>(dest), static_cast<const void*>(begin),
+                             no_elements * sizeof(T));
+                return dest + no_elements;
+            }
+        } // namespace detail
+
         /// \effects [std::move_if_noexcept]() elements of the given range to the uninitialized memory of the given block,
         /// then destroys them at the old location.
         /// \returns A pointer past the last created object.
         /// \notes If an exception is thrown, the old range has not been modified and all objects created at the new location will be destroyed.
+        /// \notes If the type is [array::is_trivially_relocatable]() and the iterators are contiguous,
+        /// this just copies the bytes.
         template <typename FwdIter>
         raw_pointer uninitialized_destructive_move(FwdIter begin, FwdIter end,
                                                    const memory_block& block)
         {
-            auto result = uninitialized_move_if_noexcept(begin, end, block);
-            destroy_range(begin, end);
-            return result;
+            using type = typename std::iterator_traits<FwdIter>::value_type;
+            return detail::uninitialized_destructive_move_impl<type>(detail::can_relocate<FwdIter,
+                                                                                          type>{},
+                                                                     begin, end, block);
+        }
+
+        namespace detail
+        {
+            template <typename T, typename ContIter>
+            raw_pointer uninitialized_destructive_move_with_gap_impl(
+                std::true_type, ContIter begin, ContIter gap_position, ContIter end,
+                size_type gap_bytes, const memory_block& block) noexcept
+            {
+                auto prefix_end = uninitialized_destructive_move_impl<T>(std::true_type{}, begin,
+                                                                         gap_position, block);
+                return uninitialized_destructive_move_impl<T>(std::true_type{}, gap_position, end,
+                                                              memory_block(prefix_end + gap_bytes,
+                                                                           block.end()));
+            }
+
+            template <typename T, typename FwdIter>
+            raw_pointer uninitialized_destructive_move_with_gap_impl(
+                std::false_type, FwdIter begin, FwdIter gap_position, FwdIter end,
+                size_type gap_bytes, const memory_block& block)
+            {
+                auto prefix_end = uninitialized_move_if_noexcept(begin, gap_position, block);
+                raw_pointer result;
+                try
+                {
+                    result = uninitialized_move_if_noexcept(gap_position, end,
+                                                            memory_block(prefix_end + gap_bytes,
+                                                                         block.end()));
+                }
+                catch (...)
+                {
+                    destroy_range(to_pointer<T>(block.begin()), to_pointer<T>(prefix_end));
+                    throw;
+                }
+                destroy_range(begin, end);
+                return result;
+            }
+        } // namespace detail
+
+        /// \effects Same as `uninitialized_destructive_move()`,
+        /// but leaves `gap_bytes` uninitialized bytes before the object at `gap_position`.
+        /// \returns A pointer past the last created object.
+        /// \notes If an exception is thrown, the old range has not been modified and all objects created at the new location will be destroyed.
+        template <typename FwdIter>
+        raw_pointer uninitialized_destructive_move_with_gap(FwdIter begin, FwdIter gap_position,
+                                                            FwdIter end, size_type gap_bytes,
+                                                            const memory_block& block)
+        {
+            using type = typename std::iterator_traits<FwdIter>::value_type;
+            assert(gap_bytes % sizeof(type) == 0u);
+            return detail::uninitialized_destructive_move_with_gap_impl<
+                type>(detail::can_relocate<FwdIter, type>{}, begin, gap_position, end, gap_bytes,
+                      block);
         }
     } // namespace array
 } // namespace foonathan
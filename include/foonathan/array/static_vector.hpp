@@ -0,0 +1,418 @@
+// Copyright (C) 2018 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#ifndef FOONATHAN_ARRAY_STATIC_VECTOR_HPP_INCLUDED
+#define FOONATHAN_ARRAY_STATIC_VECTOR_HPP_INCLUDED
+
+#include <cassert>
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include <foonathan/array/array_view.hpp>
+#include <foonathan/array/config.hpp>
+#include <foonathan/array/pointer_iterator.hpp>
+
+namespace foonathan
+{
+    namespace array
+    {
+        namespace detail
+        {
+            // the smallest unsigned type that can store values up to N
+            template <size_type N>
+            using static_vector_size_t = typename std::conditional<
+                N <= UINT8_MAX, std::uint8_t,
+                typename std::conditional<
+                    N <= UINT16_MAX, std::uint16_t,
+                    typename std::conditional<N <= UINT32_MAX, std::uint32_t,
+                                              size_type>::type>::type>::type;
+
+            // trivial types are stored in an actual array, so they can be used in constexpr,
+            // without constexpr modifications there is no reason to do so
+            template <typename T, size_type N,
+                      bool Trivial = std::is_trivial<T>::value && FOONATHAN_ARRAY_USE_CONSTEXPR14>
+            class static_vector_storage
+            {
+            public:
+#if FOONATHAN_ARRAY_HAS_CONSTEXPR_DEFAULT_INIT
+                constexpr static_vector_storage() noexcept : size_(0u) {}
+#else
+                // before C++20, a constexpr constructor has to initialize all elements
+                constexpr static_vector_storage() noexcept : data_{}, size_(0u) {}
+#endif
+
+                FOONATHAN_ARRAY_CONSTEXPR14 T* data() noexcept
+                {
+                    return data_;
+                }
+                constexpr const T* data() const noexcept
+                {
+                    return data_;
+                }
+
+                template <typename... Args>
+                FOONATHAN_ARRAY_CONSTEXPR14 T& construct(Args&&... args) noexcept(
+                    std::is_nothrow_constructible<T, Args...>::value)
+                {
+                    data_[size_] = T(std::forward<Args>(args)...);
+                    return data_[size_++];
+                }
+
+                FOONATHAN_ARRAY_CONSTEXPR14 void destroy_back() noexcept
+                {
+                    --size_;
+                }
+
+                T                       data_[N];
+                static_vector_size_t<N> size_;
+            };
+
+            template <typename T, size_type N>
+            class static_vector_storage<T, N, false>
+            {
+            public:
+                static_vector_storage() noexcept : size_(0u) {}
+
+                static_vector_storage(const static_vector_storage& other) noexcept(
+                    std::is_nothrow_copy_constructible<T>::value)
+                : size_(0u)
+                {
+                    clone(other.data(), other.data() + other.size_);
+                }
+
+                static_vector_storage(static_vector_storage&& other) noexcept(
+                    std::is_nothrow_move_constructible<T>::value)
+                : size_(0u)
+                {
+                    clone(std::make_move_iterator(other.data()),
+                          std::make_move_iterator(other.data() + other.size_));
+                }
+
+                ~static_vector_storage() noexcept
+                {
+                    clear();
+                }
+
+                static_vector_storage& operator=(const static_vector_storage& other) noexcept(
+                    std::is_nothrow_copy_constructible<T>::value)
+                {
+                    if (this != &other)
+                    {
+                        clear();
+                        clone(other.data(), other.data() + other.size_);
+                    }
+                    return *this;
+                }
+
+                static_vector_storage& operator=(static_vector_storage&& other) noexcept(
+                    std::is_nothrow_move_constructible<T>::value)
+                {
+                    if (this != &other)
+                    {
+                        clear();
+                        clone(std::make_move_iterator(other.data()),
+                              std::make_move_iterator(other.data() + other.size_));
+                    }
+                    return *this;
+                }
+
+                T* data() noexcept
+                {
+                    return reinterpret_cast<T*>(data_);
+                }
+                const T* data() const noexcept
+                {
+                    return reinterpret_cast<const T*>(data_);
+                }
+
+                template <typename... Args>
+                T& construct(Args&&... args) noexcept(
+                    std::is_nothrow_constructible<T, Args...>::value)
+                {
+                    auto ptr = ::new (static_cast<void*>(data() + size_))
+                        T(std::forward<Args>(args)...);
+                    ++size_;
+                    return *ptr;
+                }
+
+                void destroy_back() noexcept
+                {
+                    data()[--size_].~T();
+                }
+
+                alignas(T) unsigned char data_[N * sizeof(T)];
+                static_vector_size_t<N>  size_;
+
+            private:
+                void clear() noexcept
+                {
+                    while (size_ != 0u)
+                        destroy_back();
+                }
+
+                // if an exception is thrown, the already created objects are destroyed again
+                template <typename InputIt>
+                void clone(InputIt begin, InputIt end)
+                {
+                    try
+                    {
+                        for (auto cur = begin; cur != end; ++cur)
+                            construct(*cur);
+                    }
+                    catch (...)
+                    {
+                        clear();
+                        throw;
+                    }
+                }
+            };
+        } // namespace detail
+
+        /// An array with a fixed capacity of `N` elements stored directly inside the object.
+        ///
+        /// Unlike an [array::array]() with [array::block_storage_embedded](),
+        /// it never throws on overflow: use `try_emplace_back()` if it can be full,
+        /// the other insert functions require that it isn't.
+        /// If `T` is trivial, it can be used in `constexpr` functions.
+        /// \notes Its size is `N * sizeof(T)` plus the smallest unsigned integer type that can store `N`,
+        /// and padding if required by the alignment of `T`.
+        /// Before C++20, the constructor zero initializes the elements if `T` is trivial,
+        /// as required by `constexpr`.
+        template <typename T, size_type N>
+        class static_vector
+        {
+            static_assert(N > 0u, "static_vector must have a capacity");
+
+        public:
+            class iterator_tag
+            {
+                constexpr iterator_tag() = default;
+
+                friend static_vector;
+            };
+
+        public:
+            using value_type = T;
+
+            using iterator       = pointer_iterator<iterator_tag, T>;
+            using const_iterator = pointer_iterator<iterator_tag, const T>;
+
+            //=== constructors ===//
+            /// \effects Creates it without any elements.
+            static_vector() noexcept = default;
+
+            /// \effects Creates it containing copies of the elements in the list.
+            /// \requires The list must not contain more than `N` elements.
+            FOONATHAN_ARRAY_CONSTEXPR14 static_vector(std::initializer_list<T> list) noexcept(
+                std::is_nothrow_copy_constructible<T>::value)
+            : static_vector()
+            {
+                for (auto& element : list)
+                    push_back(element);
+            }
+
+            //=== access ===//
+            /// \returns An array view to the elements.
+            FOONATHAN_ARRAY_CONSTEXPR14 operator array_view<T>() noexcept
+            {
+                return array_view<T>(storage_.data(), size());
+            }
+            /// \returns A `const` array view to the elements.
+            constexpr operator array_view<const T>() const noexcept
+            {
+                return array_view<const T>(storage_.data(), size());
+            }
+
+            FOONATHAN_ARRAY_CONSTEXPR14 iterator begin() noexcept
+            {
+                return iterator(iterator_tag{}, storage_.data());
+            }
+            constexpr const_iterator begin() const noexcept
+            {
+                return const_iterator(iterator_tag{}, storage_.data());
+            }
+            constexpr const_iterator cbegin() const noexcept
+            {
+                return begin();
+            }
+
+            FOONATHAN_ARRAY_CONSTEXPR14 iterator end() noexcept
+            {
+                return iterator(iterator_tag{}, storage_.data() + size());
+            }
+            constexpr const_iterator end() const noexcept
+            {
+                return const_iterator(iterator_tag{}, storage_.data() + size());
+            }
+            constexpr const_iterator cend() const noexcept
+            {
+                return end();
+            }
+
+            /// \returns The `i`-th element.
+            /// \requires `i < size()`.
+            FOONATHAN_ARRAY_CONSTEXPR14 T& operator[](size_type i) noexcept
+            {
+                return storage_.data()[i];
+            }
+            constexpr const T& operator[](size_type i) const noexcept
+            {
+                return storage_.data()[i];
+            }
+
+            FOONATHAN_ARRAY_CONSTEXPR14 T& front() noexcept
+            {
+                return (*this)[0u];
+            }
+            constexpr const T& front() const noexcept
+            {
+                return (*this)[0u];
+            }
+
+            FOONATHAN_ARRAY_CONSTEXPR14 T& back() noexcept
+            {
+                return (*this)[size() - 1u];
+            }
+            constexpr const T& back() const noexcept
+            {
+                return (*this)[size() - 1u];
+            }
+
+            //=== capacity ===//
+            /// \returns Whether or not it is empty.
+            constexpr bool empty() const noexcept
+            {
+                return size() == 0u;
+            }
+
+            /// \returns Whether or not it is full, i.e. no elements can be inserted.
+            constexpr bool full() const noexcept
+            {
+                return size() == N;
+            }
+
+            /// \returns The number of elements.
+            constexpr size_type size() const noexcept
+            {
+                return storage_.size_;
+            }
+
+            /// \returns The number of elements it can contain, i.e. `N`.
+            static constexpr size_type capacity() noexcept
+            {
+                return N;
+            }
+
+            /// \returns The number of elements it can contain, i.e. `N`.
+            static constexpr size_type max_size() noexcept
+            {
+                return N;
+            }
+
+            //=== modifiers ===//
+            /// \effects Creates a new element at the end.
+            /// \returns A reference to the new element.
+            /// \requires It must not be full.
+            template <typename... Args>
+            FOONATHAN_ARRAY_CONSTEXPR14 T& emplace_back(Args&&... args) noexcept(
+                std::is_nothrow_constructible<T, Args...>::value)
+            {
+                assert(!full());
+                return storage_.construct(std::forward<Args>(args)...);
+            }
+
+            /// \effects Creates a new element at the end, if it isn't full.
+            /// \returns A pointer to the new element, or `nullptr` if it was full.
+            template <typename... Args>
+            FOONATHAN_ARRAY_CONSTEXPR14 T* try_emplace_back(Args&&... args) noexcept(
+                std::is_nothrow_constructible<T, Args...>::value)
+            {
+                if (full())
+                    return nullptr;
+                return &storage_.construct(std::forward<Args>(args)...);
+            }
+
+            /// \effects Same as `emplace_back(element)`.
+            FOONATHAN_ARRAY_CONSTEXPR14 void push_back(const T& element) noexcept(
+                std::is_nothrow_copy_constructible<T>::value)
+            {
+                emplace_back(element);
+            }
+            /// \effects Same as `emplace_back(std::move(element))`.
+            FOONATHAN_ARRAY_CONSTEXPR14 void push_back(T&& element) noexcept(
+                std::is_nothrow_move_constructible<T>::value)
+            {
+                emplace_back(std::move(element));
+            }
+
+            /// \effects Same as `try_emplace_back(element)`.
+            /// \returns Whether or not the element was inserted.
+            FOONATHAN_ARRAY_CONSTEXPR14 bool try_push_back(const T& element) noexcept(
+                std::is_nothrow_copy_constructible<T>::value)
+            {
+                return try_emplace_back(element) != nullptr;
+            }
+            /// \effects Same as `try_emplace_back(std::move(element))`.
+            /// \returns Whether or not the element was inserted.
+            FOONATHAN_ARRAY_CONSTEXPR14 bool try_push_back(T&& element) noexcept(
+                std::is_nothrow_move_constructible<T>::value)
+            {
+                return try_emplace_back(std::move(element)) != nullptr;
+            }
+
+            /// \effects Destroys the last element.
+            /// \requires It must not be empty.
+            FOONATHAN_ARRAY_CONSTEXPR14 void pop_back() noexcept
+            {
+                assert(!empty());
+                storage_.destroy_back();
+            }
+
+            /// \effects Destroys all elements.
+            FOONATHAN_ARRAY_CONSTEXPR14 void clear() noexcept
+            {
+                while (!empty())
+                    storage_.destroy_back();
+            }
+
+            /// \effects Destroys and removes the element at the given position,
+            /// moving the following elements to the front.
+            /// \returns An iterator after the element that was removed.
+            FOONATHAN_ARRAY_CONSTEXPR14 iterator erase(const_iterator pos) noexcept(
+                std::is_nothrow_move_assignable<T>::value)
+            {
+                return erase_range(pos, pos + 1);
+            }
+
+            /// \effects Destroys and removes all elements in the range `[begin, end)`,
+            /// moving the following elements to the front.
+            /// \returns An iterator after the last element that was removed.
+            FOONATHAN_ARRAY_CONSTEXPR14 iterator erase_range(
+                const_iterator begin,
+                const_iterator end) noexcept(std::is_nothrow_move_assignable<T>::value)
+            {
+                auto index = size_type(begin - cbegin());
+                auto count = size_type(end - begin);
+
+                // a loop instead of std::move(), as that isn't constexpr
+                auto data = storage_.data();
+                for (auto i = index; i + count < size(); ++i)
+                    data[i] = std::move(data[i + count]);
+                for (auto i = size_type(0); i != count; ++i)
+                    storage_.destroy_back();
+
+                return this->begin() + std::ptrdiff_t(index);
+            }
+
+        private:
+            detail::static_vector_storage<T, N> storage_;
+        };
+    } // namespace array
+} // namespace foonathan
+
+#endif // FOONATHAN_ARRAY_STATIC_VECTOR_HPP_INCLUDED
@@ -5,9 +5,13 @@
 #include <foonathan/array/array.hpp>
 
 #include <catch.hpp>
+#include <list>
+#include <memory>
 
 #include <foonathan/array/block_storage_embedded.hpp>
+#include <foonathan/array/block_storage_malloc.hpp>
 #include <foonathan/array/block_storage_new.hpp>
+#include <foonathan/array/block_storage_pool.hpp>
 #include <foonathan/array/block_storage_sbo.hpp>
 
 #include "equal_checker.hpp"
@@ -220,7 +224,10 @@ namespace
             {
                 auto old_cap = array.capacity();
                 array.clear();
-                REQUIRE(old_cap == array.capacity());
+                if (block_storage_auto_shrink<typename Array::block_storage>::value)
+                    REQUIRE(array.capacity() <= old_cap);
+                else
+                    REQUIRE(old_cap == array.capacity());
                 verify_array(array, {});
             }
         }
@@ -247,3 +254,249 @@ TEST_CASE("array block_storage_sbo", "[container]")
 {
     array_test_impl<test_array<block_storage_sbo<5 * sizeof(test_type), block_storage_default>>>();
 }
+
+namespace
+{
+    // an element size the heaps don't round to
+    struct twelve_bytes
+    {
+        std::uint32_t a, b, c;
+
+        twelve_bytes(std::uint32_t i) : a(i), b(i + 1u), c(i + 2u) {}
+    };
+
+    template <class BlockStorage>
+    void non_power_of_two_test()
+    {
+        for (auto n : {1u, 2u, 3u, 5u, 17u, 100u})
+        {
+            array<twelve_bytes, BlockStorage> a;
+            a.reserve(n);
+            REQUIRE(a.capacity() >= n);
+            REQUIRE(a.capacity() <= 2u * n + 16u);
+
+            // fill the entire capacity from the front, then insert past it
+            auto capacity = a.capacity();
+            for (auto i = 0u; i != capacity; ++i)
+                a.emplace(a.begin(), std::uint32_t(capacity - i - 1u));
+            twelve_bytes more[] = {std::uint32_t(capacity), std::uint32_t(capacity + 1u)};
+            a.insert_range(a.end(), std::begin(more), std::end(more));
+
+            REQUIRE(a.size() == capacity + 2u);
+            auto equal = true;
+            for (auto i = 0u; i != a.size(); ++i)
+                equal = equal && a[i].a == i && a[i].c == i + 2u;
+            REQUIRE(equal);
+        }
+    }
+} // namespace
+
+TEST_CASE("array non power of two element size", "[container]")
+{
+    non_power_of_two_test<block_storage_malloc<>>();
+    non_power_of_two_test<block_storage_pool<>>();
+    non_power_of_two_test<block_storage_new<>>();
+}
+
+TEST_CASE("array trivially relocatable", "[container]")
+{
+    array<std::unique_ptr<int>> array;
+    for (auto i = 0; i != 8; ++i)
+        array.emplace_back(new int(i));
+
+    array.emplace(array.begin() + 2, new int(42));
+    array.erase(array.begin());
+    array.erase_range(array.begin() + 4, array.begin() + 6);
+
+    auto expected = {1, 42, 2, 3, 6, 7};
+    REQUIRE(array.size() == expected.size());
+    for (auto i = 0u; i != array.size(); ++i)
+        REQUIRE(*array[i] == expected.begin()[i]);
+}
+
+TEST_CASE("array trivially copyable range", "[container]")
+{
+    int        ints[]  = {1, 2, 3};
+    long       longs[] = {4, 5};
+    array<int> array;
+
+    // contiguous source of the same type
+    array.append_range(std::begin(ints), std::end(ints));
+    // source of a different type
+    array.append_range(std::begin(longs), std::end(longs));
+    // insert in the middle
+    array.insert_range(array.begin() + 1, std::begin(longs), std::end(longs));
+    // insert from a non-contiguous range
+    std::list<int> list = {6, 7};
+    array.insert_range(array.begin(), list.begin(), list.end());
+    // insert of nothing
+    array.insert_range(array.begin() + 2, std::begin(ints), std::begin(ints));
+
+    auto copy = array;
+
+    auto expected = {6, 7, 1, 4, 5, 2, 3, 4, 5};
+    REQUIRE(copy.size() == expected.size());
+    for (auto i = 0u; i != copy.size(); ++i)
+        REQUIRE(copy[i] == expected.begin()[i]);
+}
+
+TEST_CASE("array move iterator range", "[container]")
+{
+    std::unique_ptr<int> ptrs[] = {std::unique_ptr<int>(new int(1)),
+                                   std::unique_ptr<int>(new int(2))};
+    array<std::unique_ptr<int>> array;
+    array.append_range(std::make_move_iterator(std::begin(ptrs)),
+                       std::make_move_iterator(std::end(ptrs)));
+    REQUIRE(array.size() == 2u);
+    REQUIRE(*array[0] == 1);
+    REQUIRE(*array[1] == 2);
+    REQUIRE(!ptrs[0]);
+    REQUIRE(!ptrs[1]);
+
+    std::unique_ptr<int> inserted[] = {std::unique_ptr<int>(new int(3))};
+    array.insert_range(array.begin() + 1, std::make_move_iterator(std::begin(inserted)),
+                       std::make_move_iterator(std::end(inserted)));
+    REQUIRE(array.size() == 3u);
+    REQUIRE(*array[1] == 3);
+    REQUIRE(!inserted[0]);
+}
+
+TEST_CASE("array reserve_with_gap", "[container]")
+{
+    REQUIRE(block_storage_reserve_with_gap<block_storage_new<default_growth>, test_type>::value);
+    REQUIRE(!block_storage_reserve_with_gap<block_storage_embedded<16>, test_type>::value);
+
+    leak_checker checker;
+
+    struct throwing_type : leak_tracked
+    {
+        int id;
+
+        throwing_type(int id) : id(id)
+        {
+            if (id < 0)
+                throw 0;
+        }
+    };
+
+    array<throwing_type> a;
+    for (auto i = 0; i != 4; ++i)
+        a.emplace_back(i);
+    a.shrink_to_fit();
+    REQUIRE(a.capacity() == a.size());
+
+    SECTION("emplace")
+    {
+        a.emplace(a.begin() + 1, 42);
+        REQUIRE(a.size() == 5u);
+        REQUIRE(a[0].id == 0);
+        REQUIRE(a[1].id == 42);
+        REQUIRE(a[2].id == 1);
+        REQUIRE(a[4].id == 3);
+    }
+    SECTION("emplace throws")
+    {
+        REQUIRE_THROWS(a.emplace(a.begin() + 1, -1));
+        REQUIRE(a.size() == 4u);
+        for (auto i = 0; i != 4; ++i)
+            REQUIRE(a[size_type(i)].id == i);
+    }
+    SECTION("insert_range")
+    {
+        int ids[] = {5, 6, 7, 8, 9};
+        a.insert_range(a.begin() + 2, std::begin(ids), std::end(ids));
+        REQUIRE(a.size() == 9u);
+        REQUIRE(a[1].id == 1);
+        REQUIRE(a[2].id == 5);
+        REQUIRE(a[6].id == 9);
+        REQUIRE(a[7].id == 2);
+    }
+    SECTION("insert_range throws")
+    {
+        int ids[] = {5, 6, -1};
+        REQUIRE_THROWS(a.insert_range(a.begin() + 2, std::begin(ids), std::end(ids)));
+        REQUIRE(a.size() == 4u);
+        for (auto i = 0; i != 4; ++i)
+            REQUIRE(a[size_type(i)].id == i);
+    }
+}
+
+TEST_CASE("array auto shrink", "[container]")
+{
+    using storage = block_storage_new<auto_shrink_growth<hysteresis_growth<>>>;
+    array_test_impl<test_array<storage>>();
+
+    array<int, storage> array;
+    for (auto i = 0; i != 1000; ++i)
+        array.push_back(i);
+    auto full_capacity = array.capacity();
+    REQUIRE(full_capacity >= 1000u);
+
+    // removing a few elements keeps the memory
+    auto iter = array.erase_range(array.begin(), array.begin() + 100);
+    REQUIRE(*iter == 100);
+    array.pop_back();
+    REQUIRE(array.size() == 899u);
+    REQUIRE(array.capacity() == full_capacity);
+
+    // removing most elements gives it back
+    iter = array.erase_range(array.begin() + 10, array.end() - 10);
+    REQUIRE(array.size() == 20u);
+    REQUIRE(iter == array.begin() + 10);
+    REQUIRE(*iter == 989);
+    REQUIRE(array.capacity() < full_capacity);
+    REQUIRE(array.capacity() >= 20u);
+    for (auto i = 0; i != 10; ++i)
+    {
+        REQUIRE(array[i] == 100 + i);
+        REQUIRE(array[10 + i] == 989 + i);
+    }
+
+    array.clear();
+    REQUIRE(array.capacity() == 0u);
+}
+
+TEST_CASE("array resize", "[container]")
+{
+    array<int> array;
+    array.resize(5u);
+    REQUIRE(array.size() == 5u);
+    for (auto i = 0u; i != array.size(); ++i)
+        REQUIRE(array[i] == 0);
+
+    foonathan::array::array<int> zeroed(5u, value_init);
+    REQUIRE(zeroed.size() == 5u);
+    REQUIRE(zeroed.back() == 0);
+
+    array[4u] = 4;
+    array.resize_default_init(10u);
+    REQUIRE(array.size() == 10u);
+    REQUIRE(array[4u] == 4);
+
+    auto view = array.append_uninitialized(3u);
+    REQUIRE(view.size() == 3u);
+    REQUIRE(array.size() == 13u);
+    REQUIRE(view.data() == &array[10u]);
+    for (auto i = 0u; i != view.size(); ++i)
+        view[i] = int(i);
+    REQUIRE(array.back() == 2);
+
+    array.resize(2u);
+    REQUIRE(array.size() == 2u);
+    array.resize_default_init(0u);
+    REQUIRE(array.empty());
+
+    struct default_tracked : leak_tracked
+    {
+        int value = 42;
+    };
+
+    leak_checker                             checker;
+    foonathan::array::array<default_tracked> tracked;
+    tracked.resize(3u);
+    tracked.resize_default_init(5u);
+    REQUIRE(tracked.size() == 5u);
+    REQUIRE(tracked.back().value == 42);
+    tracked.resize(1u);
+    REQUIRE(tracked.size() == 1u);
+}
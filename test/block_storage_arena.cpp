@@ -0,0 +1,133 @@
+// Copyright (C) 2018 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#include <foonathan/array/block_storage_arena.hpp>
+
+#include <catch.hpp>
+#include <cstring>
+
+#include <foonathan/array/array.hpp>
+#include <foonathan/array/flat_set.hpp>
+
+#include "block_storage_algorithm.hpp"
+
+using namespace foonathan::array;
+
+TEST_CASE("memory_arena", "[BlockStorage]")
+{
+    memory_arena arena(64u);
+
+    auto a = arena.allocate(16u, 8u);
+    REQUIRE(a.size() == 16u);
+
+    SECTION("rollback")
+    {
+        auto b = arena.allocate(8u, 8u);
+        REQUIRE(b.begin() >= a.end());
+
+        // not the last, nothing happens
+        arena.deallocate(a);
+        auto c = arena.allocate(8u, 8u);
+        REQUIRE(c.begin() >= b.end());
+
+        arena.deallocate(c);
+        arena.deallocate(b);
+        auto d = arena.allocate(8u, 8u);
+        REQUIRE(d.begin() == b.begin());
+    }
+    SECTION("try_expand")
+    {
+        REQUIRE(arena.try_expand(a, 32u));
+        REQUIRE(a.size() == 32u);
+        REQUIRE(!arena.try_expand(a, 1024u));
+
+        auto b = arena.allocate(8u, 8u);
+        REQUIRE(!arena.try_expand(a, 48u));
+        REQUIRE(arena.try_expand(b, 16u));
+    }
+    SECTION("rewind")
+    {
+        auto marker = arena.top();
+        auto b      = arena.allocate(16u, 8u);
+        auto big    = arena.allocate(1024u, 8u);
+        REQUIRE(big.size() == 1024u);
+
+        arena.rewind(marker);
+        auto c = arena.allocate(16u, 8u);
+        REQUIRE(c.begin() == b.begin());
+    }
+    SECTION("scope")
+    {
+        raw_pointer begin;
+        {
+            arena_scope scope(arena);
+            begin = arena.allocate(16u, 8u).begin();
+            arena.allocate(4096u, 8u);
+        }
+        REQUIRE(arena.allocate(16u, 8u).begin() == begin);
+    }
+    SECTION("reset")
+    {
+        arena.allocate(4096u, 8u);
+        arena.reset();
+
+        // reuses the big chunk
+        auto b = arena.allocate(2048u, 8u);
+        REQUIRE(arena.try_expand(b, 4096u));
+    }
+}
+
+TEST_CASE("memory_arena chunk end", "[BlockStorage]")
+{
+    SECTION("alignment past the end")
+    {
+        // chunk memory is aligned, so the end of the chunk is not
+        memory_arena arena(61u);
+        auto         a = arena.allocate(60u, 1u);
+
+        auto b = arena.allocate(8u, 16u);
+        REQUIRE(b.size() == 8u);
+        REQUIRE(b.begin() != a.begin() + 64);
+        std::memset(to_void_pointer(b.begin()), 0, b.size());
+    }
+    SECTION("zero chunk size")
+    {
+        memory_arena arena(0u);
+        auto         a = arena.allocate(100u, 8u);
+        REQUIRE(a.size() == 100u);
+    }
+}
+
+TEST_CASE("block_storage_arena", "[BlockStorage]")
+{
+    memory_arena arena;
+    auto         args = block_storage_arg(arena_heap::handle_type(arena));
+
+    test::test_block_storage_algorithm<block_storage_arena<default_growth>>(args);
+    test::test_block_storage_algorithm<block_storage_arena<no_extra_growth>>(args);
+
+    SECTION("growth of last array is in place")
+    {
+        arena_scope scope(arena);
+
+        array<int, block_storage_arena<default_growth>> a(args);
+        a.push_back(0);
+        auto data = iterator_to_pointer(a.begin());
+        for (auto i = 1; i != 512; ++i)
+            a.push_back(i);
+        REQUIRE(iterator_to_pointer(a.begin()) == data);
+        for (auto i = 0; i != 512; ++i)
+            REQUIRE(a[size_type(i)] == i);
+    }
+    SECTION("flat_set")
+    {
+        arena_scope scope(arena);
+
+        flat_set<int, key_compare_default, block_storage_arena<default_growth>> set(args);
+        for (auto i = 100; i != 0; --i)
+            set.insert(i);
+        REQUIRE(set.size() == 100u);
+        REQUIRE(set.contains(42));
+    }
+}
@@ -0,0 +1,181 @@
+// Copyright (C) 2018 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#include <foonathan/array/block_storage_cow.hpp>
+
+#include <catch.hpp>
+
+#include <foonathan/array/array.hpp>
+#include <foonathan/array/bag.hpp>
+#include <foonathan/array/flat_map.hpp>
+#include <foonathan/array/flat_set.hpp>
+
+#include "block_storage_algorithm.hpp"
+#include "leak_checker.hpp"
+
+using namespace foonathan::array;
+
+namespace
+{
+    struct cow_tracked : leak_tracked
+    {
+        int value;
+
+        cow_tracked(int i) : value(i) {}
+    };
+
+    template <typename T>
+    using cow_array = array<T, block_storage_cow<>>;
+}
+
+TEST_CASE("block_storage_cow", "[BlockStorage]")
+{
+    REQUIRE(block_storage_copy_on_write<block_storage_cow<>>::value);
+    REQUIRE(!block_storage_copy_on_write<block_storage_new<default_growth>>::value);
+    REQUIRE(!noexcept(std::declval<cow_array<int>&>().begin()));
+    REQUIRE(noexcept(std::declval<const cow_array<int>&>().begin()));
+
+    test::test_block_storage_algorithm<block_storage_cow<>>({});
+    test::test_block_storage_algorithm<block_storage_cow<new_heap, no_extra_growth>>({});
+}
+
+TEST_CASE("array block_storage_cow", "[container]")
+{
+    leak_checker checker;
+
+    cow_array<cow_tracked> a;
+    for (auto i = 0; i != 10; ++i)
+        a.emplace_back(i);
+
+    SECTION("copy shares")
+    {
+        cow_array<cow_tracked> b(a);
+        const auto&            ca = a;
+        const auto&            cb = b;
+        REQUIRE(&cb[0] == &ca[0]);
+        REQUIRE(cb.size() == 10u);
+        REQUIRE(cb[3].value == 3);
+
+        // modification copies
+        b[3].value = 42;
+        REQUIRE(&cb[0] != &ca[0]);
+        REQUIRE(cb[3].value == 42);
+        REQUIRE(ca[3].value == 3);
+
+        // no longer shared, so no more copies
+        auto data = &cb[0];
+        b[4].value = 43;
+        b.pop_back();
+        REQUIRE(&cb[0] == data);
+    }
+    SECTION("copy outlives original")
+    {
+        auto b = std::unique_ptr<cow_array<cow_tracked>>(new cow_array<cow_tracked>(a));
+        a.emplace_back(10);
+        REQUIRE(a.size() == 11u);
+        REQUIRE(b->size() == 10u);
+
+        cow_array<cow_tracked> c(*b);
+        b.reset();
+        REQUIRE(c.size() == 10u);
+        REQUIRE(c.back().value == 9);
+    }
+    SECTION("erase on shared copy")
+    {
+        cow_array<cow_tracked> b(a);
+        auto                   iter = b.erase_range(b.cbegin() + 2, b.cbegin() + 4);
+        REQUIRE(iter->value == 4);
+        REQUIRE(b.size() == 8u);
+        REQUIRE(a.size() == 10u);
+        REQUIRE(static_cast<const cow_array<cow_tracked>&>(a)[2].value == 2);
+
+        b.erase(b.cbegin());
+        REQUIRE(b.front().value == 1);
+    }
+    SECTION("insert on shared copy")
+    {
+        cow_array<cow_tracked> b(a);
+        b.insert(b.cbegin() + 1, cow_tracked(-1));
+        REQUIRE(b.size() == 11u);
+        REQUIRE(b[1].value == -1);
+        REQUIRE(b[2].value == 1);
+        REQUIRE(a.size() == 10u);
+    }
+    SECTION("assignment and clear")
+    {
+        cow_array<cow_tracked> b;
+        b.emplace_back(-1);
+        b = a;
+        REQUIRE(&static_cast<const cow_array<cow_tracked>&>(b)[0]
+                == &static_cast<const cow_array<cow_tracked>&>(a)[0]);
+
+        cow_array<cow_tracked> c(b);
+        c.clear();
+        REQUIRE(c.empty());
+        REQUIRE(b.size() == 10u);
+
+        c = std::move(b);
+        REQUIRE(c.size() == 10u);
+
+        a.clear();
+        REQUIRE(a.empty());
+        REQUIRE(c[9].value == 9);
+
+        a.assign_range(c.begin(), c.end());
+        REQUIRE(a.size() == 10u);
+    }
+}
+
+TEST_CASE("bag block_storage_cow", "[container]")
+{
+    bag<int, block_storage_cow<>> a;
+    for (auto i = 0; i != 5; ++i)
+        a.insert(i);
+
+    auto b = a;
+    b.erase(b.cbegin());
+    REQUIRE(a.size() == 5u);
+    REQUIRE(b.size() == 4u);
+}
+
+TEST_CASE("flat_set/flat_map block_storage_cow", "[container]")
+{
+    flat_set<int, key_compare_default, block_storage_cow<>> set;
+    flat_map<int, int, key_compare_default, block_storage_cow<>> map;
+    for (auto i = 0; i != 10; ++i)
+    {
+        set.insert(i);
+        map.insert(i, 2 * i);
+    }
+
+    auto set_copy = set;
+    auto map_copy = map;
+
+    // const lookups don't copy
+    const auto& cmap_copy = map_copy;
+    REQUIRE(set_copy.contains(3));
+    REQUIRE(*cmap_copy.try_lookup(3) == 6);
+    REQUIRE(cmap_copy.values().data() == static_cast<const decltype(map)&>(map).values().data());
+
+    // modification does
+    map_copy.lookup(3) = 0;
+    REQUIRE(map.lookup(3) == 6);
+    REQUIRE(map_copy.lookup(3) == 0);
+
+    auto erase_copy = map;
+    auto after      = erase_copy.erase(erase_copy.cbegin() + 2);
+    REQUIRE(after->key == 3);
+    REQUIRE(after->value == 6);
+    REQUIRE(erase_copy.size() == 9u);
+    REQUIRE(!erase_copy.contains(2));
+    REQUIRE(map.size() == 10u);
+    REQUIRE(map.contains(2));
+
+    set_copy.erase_all(3);
+    map_copy.erase_all(4);
+    REQUIRE(set.contains(3));
+    REQUIRE(!set_copy.contains(3));
+    REQUIRE(map.contains(4));
+    REQUIRE(!map_copy.contains(4));
+}
@@ -0,0 +1,260 @@
+// Copyright (C) 2018 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#include <foonathan/array/block_storage_heap.hpp>
+
+#include <catch.hpp>
+#include <cstdint>
+#include <cstdlib>
+
+#include <foonathan/array/array.hpp>
+
+#include "block_storage_algorithm.hpp"
+#include "leak_checker.hpp"
+
+using namespace foonathan::array;
+
+namespace
+{
+    // bump allocator on a static buffer, the last block can be expanded
+    struct expanding_heap
+    {
+        struct handle_type
+        {
+        };
+
+        static byte* buffer_begin()
+        {
+            alignas(std::max_align_t) static byte buffer[1024];
+            return buffer;
+        }
+        static raw_pointer& top()
+        {
+            static raw_pointer ptr = buffer_begin();
+            return ptr;
+        }
+        static unsigned& expand_count()
+        {
+            static unsigned count = 0u;
+            return count;
+        }
+
+        static memory_block allocate(handle_type&, size_type size, size_type)
+        {
+            auto offset = size_type(top() - buffer_begin());
+            auto begin  = buffer_begin()
+                         + ((offset + alignof(std::max_align_t) - 1u)
+                            & ~(alignof(std::max_align_t) - 1u));
+            if (begin + size > buffer_begin() + 1024)
+                throw std::bad_alloc();
+
+            top() = begin + size;
+            return memory_block(begin, size);
+        }
+
+        static bool try_expand(handle_type&, memory_block& block, size_type new_size) noexcept
+        {
+            if (block.end() != top() || block.begin() + new_size > buffer_begin() + 1024)
+                return false;
+
+            ++expand_count();
+            top() = block.begin() + new_size;
+            block = memory_block(block.begin(), new_size);
+            return true;
+        }
+
+        static void deallocate(handle_type&, memory_block&&) noexcept {}
+
+        static size_type max_size(const handle_type&) noexcept
+        {
+            return 1024u;
+        }
+    };
+
+    // malloc based heap that counts calls to reallocate
+    struct reallocating_heap
+    {
+        struct handle_type
+        {
+        };
+
+        static unsigned& reallocate_count()
+        {
+            static unsigned count = 0u;
+            return count;
+        }
+
+        static memory_block allocate(handle_type&, size_type size, size_type)
+        {
+            return {to_raw_pointer(std::malloc(size)), size};
+        }
+
+        static memory_block reallocate(handle_type&, memory_block&& block, size_type new_size,
+                                       size_type)
+        {
+            ++reallocate_count();
+            return {to_raw_pointer(std::realloc(to_void_pointer(block.begin()), new_size)),
+                    new_size};
+        }
+
+        static void deallocate(handle_type&, memory_block&& block) noexcept
+        {
+            std::free(to_void_pointer(block.begin()));
+        }
+
+        static size_type max_size(const handle_type&) noexcept
+        {
+            return memory_block::max_size();
+        }
+    };
+
+    // malloc based heap that rounds up to multiples of 64
+    struct rounding_heap
+    {
+        struct handle_type
+        {
+        };
+
+        static memory_block allocate(handle_type&, size_type size, size_type)
+        {
+            return {to_raw_pointer(std::malloc(size)), size};
+        }
+
+        static void deallocate(handle_type&, memory_block&& block) noexcept
+        {
+            std::free(to_void_pointer(block.begin()));
+        }
+
+        static size_type good_size(const handle_type&, size_type size) noexcept
+        {
+            return (size + 63u) / 64u * 64u;
+        }
+
+        static size_type max_size(const handle_type&) noexcept
+        {
+            return memory_block::max_size();
+        }
+    };
+
+    struct test_type : leak_tracked
+    {
+        int id;
+
+        test_type(int i) : id(i) {}
+    };
+
+    struct alignas(64) over_aligned
+    {
+        int id;
+
+        over_aligned(int i) : id(i) {}
+    };
+
+    bool is_aligned(const void* ptr, std::size_t alignment)
+    {
+        return reinterpret_cast<std::uintptr_t>(ptr) % alignment == 0u;
+    }
+} // namespace
+
+TEST_CASE("block_storage_heap", "[BlockStorage]")
+{
+    SECTION("try_expand")
+    {
+        REQUIRE(detail::heap_has_try_expand<expanding_heap>::value);
+
+        array<int, block_storage_heap<expanding_heap, default_growth>> a;
+        a.push_back(0);
+        auto data = iterator_to_pointer(a.begin());
+
+        auto old_count = expanding_heap::expand_count();
+        for (auto i = 1; i != 16; ++i)
+            a.push_back(i);
+        REQUIRE(expanding_heap::expand_count() > old_count);
+        REQUIRE(iterator_to_pointer(a.begin()) == data);
+        for (auto i = 0; i != 16; ++i)
+            REQUIRE(a[size_type(i)] == i);
+
+        // inserting in the middle of the full array also expands in place
+        REQUIRE(a.capacity() == a.size());
+        old_count = expanding_heap::expand_count();
+        a.emplace(a.begin() + 1, 42);
+        REQUIRE(expanding_heap::expand_count() > old_count);
+        REQUIRE(iterator_to_pointer(a.begin()) == data);
+        REQUIRE(a[0] == 0);
+        REQUIRE(a[1] == 42);
+        REQUIRE(a[16] == 15);
+    }
+    SECTION("reallocate")
+    {
+        REQUIRE(detail::heap_has_reallocate<reallocating_heap>::value);
+        REQUIRE(!detail::heap_has_reallocate<expanding_heap>::value);
+
+        test::test_block_storage_algorithm<block_storage_heap<reallocating_heap, default_growth>>(
+            {});
+
+        {
+            auto old_count = reallocating_heap::reallocate_count();
+
+            array<int, block_storage_heap<reallocating_heap, default_growth>> a;
+            for (auto i = 0; i != 64; ++i)
+                a.push_back(i);
+            REQUIRE(reallocating_heap::reallocate_count() > old_count);
+            for (auto i = 0; i != 64; ++i)
+                REQUIRE(a[size_type(i)] == i);
+        }
+        {
+            leak_checker checker;
+            auto         old_count = reallocating_heap::reallocate_count();
+
+            // not trivially copyable, so must not use reallocate
+            array<test_type, block_storage_heap<reallocating_heap, default_growth>> a;
+            for (auto i = 0; i != 64; ++i)
+                a.push_back(i);
+            REQUIRE(reallocating_heap::reallocate_count() == old_count);
+            for (auto i = 0; i != 64; ++i)
+                REQUIRE(a[size_type(i)].id == i);
+        }
+    }
+    SECTION("over-aligned")
+    {
+        auto old_count = reallocating_heap::reallocate_count();
+
+        array<over_aligned, block_storage_heap<reallocating_heap, default_growth>> a;
+        for (auto i = 0; i != 64; ++i)
+        {
+            a.push_back(i);
+            REQUIRE(is_aligned(iterator_to_pointer(a.begin()), 64u));
+        }
+        // the heap does not know the alignment, so must not use reallocate
+        REQUIRE(reallocating_heap::reallocate_count() == old_count);
+        for (auto i = 0; i != 64; ++i)
+            REQUIRE(a[size_type(i)].id == i);
+
+        a.erase_range(a.begin() + 4, a.end());
+        a.shrink_to_fit();
+        REQUIRE(is_aligned(iterator_to_pointer(a.begin()), 64u));
+        REQUIRE(a.capacity() >= 4u);
+        for (auto i = 0; i != 4; ++i)
+            REQUIRE(a[size_type(i)].id == i);
+    }
+    SECTION("good_size")
+    {
+        REQUIRE(detail::heap_has_good_size<rounding_heap>::value);
+        REQUIRE(!detail::heap_has_good_size<reallocating_heap>::value);
+
+        test::test_block_storage_algorithm<block_storage_heap<rounding_heap, no_extra_growth>>(
+            {});
+
+        array<char, block_storage_heap<rounding_heap, default_growth>> a;
+        a.reserve(10u);
+        REQUIRE(a.capacity() == 64u);
+
+        a.push_back('a');
+        a.shrink_to_fit();
+        REQUIRE(a.capacity() == 64u);
+
+        a.reserve(65u);
+        REQUIRE(a.capacity() == 128u);
+    }
+}
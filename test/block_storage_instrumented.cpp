@@ -0,0 +1,176 @@
+// Copyright (C) 2018 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#include <foonathan/array/block_storage_instrumented.hpp>
+
+#include <catch.hpp>
+#include <cstring>
+
+#include <foonathan/array/array.hpp>
+#include <foonathan/array/block_storage_cow.hpp>
+#include <foonathan/array/block_storage_malloc.hpp>
+#include <foonathan/array/block_storage_new.hpp>
+#include <foonathan/array/block_storage_sbo.hpp>
+
+#include "block_storage_algorithm.hpp"
+
+using namespace foonathan::array;
+
+namespace
+{
+    struct heap_tag
+    {
+        static const char* name() noexcept
+        {
+            return "heap_tag";
+        }
+    };
+
+    struct sbo_tag
+    {
+    };
+
+    struct cow_tag
+    {
+    };
+} // namespace
+
+TEST_CASE("block_storage_instrumented", "[BlockStorage]")
+{
+    test::test_block_storage_algorithm<block_storage_instrumented<block_storage_new<>>>({});
+    test::test_block_storage_algorithm<
+        block_storage_instrumented<block_storage_sbo<16, block_storage_new<>>>>({});
+}
+
+TEST_CASE("block_storage_instrumented heap", "[BlockStorage]")
+{
+    using storage    = block_storage_instrumented<block_storage_new<no_extra_growth>, heap_tag>;
+    auto& statistics = storage::statistics();
+    REQUIRE(&statistics == &storage_statistics::of<heap_tag>());
+    REQUIRE(std::strcmp(statistics.name(), "heap_tag") == 0);
+
+    {
+        array<int, storage> a;
+        REQUIRE(statistics.allocations() == 0u);
+
+        a.reserve(4u);
+        REQUIRE(statistics.allocations() == 1u);
+        REQUIRE(statistics.deallocations() == 0u);
+        REQUIRE(statistics.bytes_allocated() == 4u * sizeof(int));
+        REQUIRE(statistics.bytes_relocated() == 0u);
+        REQUIRE(statistics.bytes_wasted() == 0u);
+        REQUIRE(statistics.capacity() == 4u * sizeof(int));
+
+        for (auto i = 0; i != 4; ++i)
+            a.push_back(i);
+        a.reserve(8u);
+        REQUIRE(statistics.allocations() == 2u);
+        REQUIRE(statistics.deallocations() == 1u);
+        REQUIRE(statistics.bytes_allocated() == 12u * sizeof(int));
+        REQUIRE(statistics.bytes_relocated() == 4u * sizeof(int));
+        REQUIRE(statistics.capacity() == 8u * sizeof(int));
+        REQUIRE(statistics.peak_capacity() == 8u * sizeof(int));
+
+        auto copy = a;
+        REQUIRE(statistics.allocations() == 3u);
+        REQUIRE(statistics.capacity() == 12u * sizeof(int));
+        REQUIRE(statistics.peak_capacity() == 12u * sizeof(int));
+
+        a.shrink_to_fit();
+        REQUIRE(statistics.allocations() == 4u);
+        REQUIRE(statistics.deallocations() == 2u);
+        REQUIRE(statistics.bytes_relocated() == 8u * sizeof(int));
+        REQUIRE(statistics.capacity() == 8u * sizeof(int));
+        REQUIRE(statistics.peak_capacity() == 12u * sizeof(int));
+    }
+    REQUIRE(statistics.deallocations() == 4u);
+    REQUIRE(statistics.capacity() == 0u);
+
+    statistics.reset();
+    REQUIRE(statistics.allocations() == 0u);
+    REQUIRE(statistics.peak_capacity() == 0u);
+
+    auto found = false;
+    storage_statistics::for_each([&](const storage_statistics& s) {
+        if (&s == &statistics)
+            found = true;
+    });
+    REQUIRE(found);
+}
+
+TEST_CASE("block_storage_instrumented sbo", "[BlockStorage]")
+{
+    using storage =
+        block_storage_instrumented<block_storage_sbo<4 * sizeof(int), block_storage_new<>>,
+                                   sbo_tag>;
+    auto& statistics = storage::statistics();
+    REQUIRE(statistics.name() == nullptr);
+
+    array<int, storage> a;
+    for (auto i = 0; i != 4; ++i)
+        a.push_back(i);
+    // the small buffer isn't counted
+    REQUIRE(statistics.allocations() == 0u);
+    REQUIRE(statistics.capacity() == 0u);
+
+    a.push_back(4);
+    REQUIRE(statistics.allocations() == 1u);
+    REQUIRE(statistics.deallocations() == 0u);
+    REQUIRE(statistics.bytes_relocated() == 4u * sizeof(int));
+    REQUIRE(statistics.bytes_wasted() == a.capacity() * sizeof(int) - 5u * sizeof(int));
+
+    // moving just transfers ownership
+    auto moved = std::move(a);
+    REQUIRE(statistics.allocations() == 1u);
+    REQUIRE(statistics.bytes_relocated() == 4u * sizeof(int));
+    REQUIRE(statistics.capacity() == moved.capacity() * sizeof(int));
+
+    // shrinking moves it back into the small buffer
+    moved.pop_back();
+    moved.shrink_to_fit();
+    REQUIRE(statistics.allocations() == 1u);
+    REQUIRE(statistics.deallocations() == 1u);
+    REQUIRE(statistics.bytes_relocated() == 8u * sizeof(int));
+    REQUIRE(statistics.capacity() == 0u);
+}
+
+TEST_CASE("block_storage_instrumented forwarding", "[BlockStorage]")
+{
+    REQUIRE(block_storage_reserve_with_gap<block_storage_instrumented<block_storage_new<>>,
+                                           int>::value);
+    REQUIRE(!block_storage_reserve_zeroed<block_storage_instrumented<block_storage_new<>>,
+                                          int>::value);
+    REQUIRE(block_storage_reserve_zeroed<block_storage_instrumented<block_storage_malloc<>>,
+                                         int>::value);
+    REQUIRE(!block_storage_copy_on_write<block_storage_instrumented<block_storage_new<>>>::value);
+    REQUIRE(block_storage_copy_on_write<block_storage_instrumented<block_storage_cow<>>>::value);
+
+    using storage    = block_storage_instrumented<block_storage_cow<>, cow_tag>;
+    auto& statistics = storage::statistics();
+    {
+        array<int, storage> a;
+        for (auto i = 0; i != 4; ++i)
+            a.push_back(i);
+        auto allocations   = statistics.allocations();
+        auto deallocations = statistics.deallocations();
+        auto capacity      = statistics.capacity();
+
+        // the copy shares the memory
+        auto        copy  = a;
+        const auto& ccopy = copy;
+        REQUIRE(&ccopy[0] == &static_cast<const array<int, storage>&>(a)[0]);
+        REQUIRE(statistics.allocations() == allocations);
+        REQUIRE(statistics.capacity() == 2u * capacity);
+
+        // modification copies
+        copy[0] = 42;
+        REQUIRE(&ccopy[0] != &static_cast<const array<int, storage>&>(a)[0]);
+        REQUIRE(statistics.allocations() == allocations + 1u);
+        REQUIRE(statistics.deallocations() == deallocations);
+        REQUIRE(statistics.capacity() == 2u * capacity);
+        REQUIRE(a[0] == 0);
+    }
+    REQUIRE(statistics.capacity() == 0u);
+    REQUIRE(statistics.deallocations() == statistics.allocations());
+}
@@ -0,0 +1,61 @@
+// Copyright (C) 2018 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#include <foonathan/array/block_storage_malloc.hpp>
+
+#include <catch.hpp>
+#include <cstdint>
+
+#include <foonathan/array/array.hpp>
+
+#include "block_storage_algorithm.hpp"
+
+using namespace foonathan::array;
+
+TEST_CASE("block_storage_malloc", "[BlockStorage]")
+{
+    REQUIRE(sizeof(block_storage_malloc<default_growth>) == sizeof(memory_block));
+
+    test::test_block_storage_algorithm<block_storage_malloc<default_growth>>({});
+    test::test_block_storage_algorithm<block_storage_malloc<no_extra_growth>>({});
+
+    array<std::uint64_t, block_storage_malloc<>> a;
+    for (auto i = 0u; i != 1024u; ++i)
+        a.push_back(i);
+    REQUIRE(a.size() == 1024u);
+    for (auto i = 0u; i != 1024u; ++i)
+        REQUIRE(a[i] == i);
+
+    a.shrink_to_fit();
+    // might use the entire usable size of the allocation
+    REQUIRE(a.capacity() >= 1024u);
+    REQUIRE(a.capacity() < 1100u);
+    for (auto i = 0u; i != 1024u; ++i)
+        REQUIRE(a[i] == i);
+}
+
+TEST_CASE("block_storage_malloc zeroed", "[BlockStorage]")
+{
+    REQUIRE(block_storage_reserve_zeroed<block_storage_malloc<>, int>::value);
+    REQUIRE(!block_storage_reserve_zeroed<block_storage_new<>, int>::value);
+
+    // dirty the heap, so calloc() can't simply reuse a fresh chunk
+    {
+        array<std::uint64_t, block_storage_malloc<>> dirty;
+        for (auto i = 0u; i != 4096u; ++i)
+            dirty.push_back(~std::uint64_t(0));
+    }
+
+    array<std::uint64_t, block_storage_malloc<>> a(4096u, value_init);
+    REQUIRE(a.size() == 4096u);
+    for (auto i = 0u; i != a.size(); ++i)
+        REQUIRE(a[i] == 0u);
+
+    a[0] = 1u;
+    a.resize(10000u);
+    REQUIRE(a.size() == 10000u);
+    REQUIRE(a[0] == 1u);
+    for (auto i = 1u; i != a.size(); ++i)
+        REQUIRE(a[i] == 0u);
+}
@@ -0,0 +1,89 @@
+// Copyright (C) 2018 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#include <foonathan/array/block_storage_mapped_file.hpp>
+
+#include <catch.hpp>
+#include <cstdint>
+#include <string>
+
+#include <foonathan/array/array.hpp>
+
+using namespace foonathan::array;
+
+namespace
+{
+    using storage    = block_storage_mapped_file<>;
+    using file_array = array<std::uint64_t, storage>;
+
+    std::string temporary_path()
+    {
+        return "/tmp/foonathan_array_test_" + std::to_string(::getpid()) + ".bin";
+    }
+
+    file_array restore_array(mapped_file& file)
+    {
+        storage s(block_storage_arg(&file));
+        auto    constructed = s.restore<std::uint64_t>();
+        return file_array(input_view<std::uint64_t, storage>(std::move(s), constructed),
+                          block_storage_arg(&file));
+    }
+} // namespace
+
+TEST_CASE("block_storage_mapped_file", "[BlockStorage]")
+{
+    auto path = temporary_path();
+    ::unlink(path.c_str());
+
+    {
+        mapped_file file(path.c_str());
+        REQUIRE(file.size() == 0u);
+
+        file_array a(block_storage_arg(&file));
+        for (auto i = 0u; i != 1000u; ++i)
+            a.push_back(i);
+        REQUIRE(file.size() == a.capacity() * sizeof(std::uint64_t));
+
+        // the file can't be used by a second storage
+        REQUIRE_THROWS_AS(file_array(a), std::logic_error);
+
+        a.shrink_to_fit();
+        REQUIRE(file.size() == 1000u * sizeof(std::uint64_t));
+    }
+    {
+        mapped_file file(path.c_str());
+        REQUIRE(file.size() == 1000u * sizeof(std::uint64_t));
+
+        auto a = restore_array(file);
+        REQUIRE(a.size() == 1000u);
+        auto equal = true;
+        for (auto i = 0u; i != 1000u; ++i)
+            equal = equal && a[i] == i;
+        REQUIRE(equal);
+
+        a.erase_range(a.begin() + 10, a.end());
+        a.push_back(42u);
+        a.shrink_to_fit();
+    }
+    {
+        mapped_file file(path.c_str());
+        auto        a = restore_array(file);
+        REQUIRE(a.size() == 11u);
+        REQUIRE(a[9] == 9u);
+        REQUIRE(a.back() == 42u);
+
+        a.clear();
+        a.shrink_to_fit();
+        REQUIRE(file.size() == 0u);
+    }
+    {
+        mapped_file file(path.c_str());
+        REQUIRE(::ftruncate(file.native_handle(), 12) == 0);
+
+        storage s(block_storage_arg(&file));
+        REQUIRE_THROWS_AS(s.restore<std::uint64_t>(), std::length_error);
+    }
+
+    ::unlink(path.c_str());
+}
@@ -0,0 +1,150 @@
+// Copyright (C) 2018 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#include <foonathan/array/block_storage_mmap.hpp>
+
+#include <catch.hpp>
+#include <cstdint>
+#include <cstring>
+
+#include <foonathan/array/array.hpp>
+
+#include "block_storage_algorithm.hpp"
+
+using namespace foonathan::array;
+
+TEST_CASE("block_storage_mmap", "[BlockStorage]")
+{
+    REQUIRE(sizeof(block_storage_mmap<default_growth>)
+            == sizeof(memory_block) + sizeof(mmap_heap::handle_type));
+
+    SECTION("default")
+    {
+        test::test_block_storage_algorithm<block_storage_mmap<default_growth>>({});
+        test::test_block_storage_algorithm<block_storage_mmap<no_extra_growth>>({});
+    }
+    SECTION("always mmap")
+    {
+        for (auto mode :
+             {huge_page_mode::disabled, huge_page_mode::advise, huge_page_mode::map_hugetlb})
+        {
+            auto args = block_storage_arg(mmap_heap::handle_type(1u, mode));
+            test::test_block_storage_algorithm<block_storage_mmap<default_growth>>(args);
+
+            array<std::uint64_t, block_storage_mmap<default_growth>> a(args);
+            a.push_back(0u);
+            // rounded up to at least a page
+            REQUIRE(a.capacity() * sizeof(std::uint64_t) >= 4096u);
+            REQUIRE(reinterpret_cast<std::uintptr_t>(iterator_to_pointer(a.begin())) % 4096u
+                    == 0u);
+
+            for (auto i = 1u; i != 10000u; ++i)
+                a.push_back(i);
+            for (auto i = 0u; i != 10000u; ++i)
+                REQUIRE(a[i] == i);
+        }
+    }
+    SECTION("threshold")
+    {
+        mmap_heap::handle_type handle(1024u, huge_page_mode::disabled);
+        REQUIRE(!mmap_heap::is_mapped(handle, 1023u));
+        REQUIRE(mmap_heap::is_mapped(handle, 1024u));
+
+        REQUIRE(mmap_heap::good_size(handle, 16u) == 16u);
+        REQUIRE(mmap_heap::good_size(handle, 1025u) % 4096u == 0u);
+
+        auto zeroed = mmap_heap::allocate_zeroed(handle, 16u, 8u);
+        REQUIRE(zeroed.size() == 16u);
+        REQUIRE(*to_pointer<std::uint64_t>(zeroed.begin()) == 0u);
+        mmap_heap::deallocate(handle, std::move(zeroed));
+
+        auto small = mmap_heap::allocate(handle, 16u, 8u);
+        REQUIRE(small.size() == 16u);
+        mmap_heap::deallocate(handle, std::move(small));
+
+        auto big = mmap_heap::allocate(handle, 1025u, 8u);
+        REQUIRE(big.size() >= 1025u);
+        REQUIRE(mmap_heap::is_mapped(handle, big.size()));
+        mmap_heap::deallocate(handle, std::move(big));
+    }
+}
+
+#ifdef MREMAP_MAYMOVE
+TEST_CASE("mmap_heap mremap", "[BlockStorage]")
+{
+    REQUIRE(detail::heap_has_try_expand<mmap_heap>::value);
+    REQUIRE(detail::heap_has_reallocate<mmap_heap>::value);
+
+    mmap_heap::handle_type handle(4096u, huge_page_mode::disabled);
+
+    SECTION("mapped")
+    {
+        auto block = mmap_heap::allocate(handle, 4096u, 8u);
+        std::memset(to_void_pointer(block.begin()), 42, block.size());
+
+        auto old_begin = block.begin();
+        if (mmap_heap::try_expand(handle, block, 8192u))
+        {
+            REQUIRE(block.begin() == old_begin);
+            REQUIRE(block.size() == 8192u);
+        }
+
+        block = mmap_heap::reallocate(handle, std::move(block), 1024u * 1024u, 8u);
+        REQUIRE(block.size() == 1024u * 1024u);
+        for (auto i = 0u; i != 4096u; ++i)
+            REQUIRE(block.begin()[i] == byte(42));
+
+        mmap_heap::deallocate(handle, std::move(block));
+    }
+    SECTION("crossing threshold")
+    {
+        auto block = mmap_heap::allocate(handle, 100u, 8u);
+        std::memset(to_void_pointer(block.begin()), 42, block.size());
+        REQUIRE(!mmap_heap::try_expand(handle, block, 200u));
+
+        block = mmap_heap::reallocate(handle, std::move(block), 10000u, 8u);
+        REQUIRE(mmap_heap::is_mapped(handle, block.size()));
+        for (auto i = 0u; i != 100u; ++i)
+            REQUIRE(block.begin()[i] == byte(42));
+
+        block = mmap_heap::reallocate(handle, std::move(block), 50u, 8u);
+        REQUIRE(!mmap_heap::is_mapped(handle, block.size()));
+        for (auto i = 0u; i != 50u; ++i)
+            REQUIRE(block.begin()[i] == byte(42));
+
+        mmap_heap::deallocate(handle, std::move(block));
+    }
+    SECTION("array")
+    {
+        array<std::uint64_t, block_storage_mmap<default_growth>> a(block_storage_arg(handle));
+        for (auto i = 0u; i != 100000u; ++i)
+            a.push_back(i);
+        auto equal = true;
+        for (auto i = 0u; i != 100000u; ++i)
+            equal = equal && a[i] == i;
+        REQUIRE(equal);
+
+        a.erase_range(a.begin() + 10, a.end());
+        a.shrink_to_fit();
+        REQUIRE(a.size() == 10u);
+        for (auto i = 0u; i != 10u; ++i)
+            REQUIRE(a[i] == i);
+    }
+    SECTION("huge pages")
+    {
+        // mremap() can fail for huge pages, then it has to copy
+        mmap_heap::handle_type huge_handle(4096u, huge_page_mode::map_hugetlb);
+
+        auto block = mmap_heap::allocate(huge_handle, 4096u, 8u);
+        std::memset(to_void_pointer(block.begin()), 42, 4096u);
+
+        block = mmap_heap::reallocate(huge_handle, std::move(block), 3u * 1024u * 1024u, 8u);
+        REQUIRE(block.size() >= 3u * 1024u * 1024u);
+        for (auto i = 0u; i != 4096u; ++i)
+            REQUIRE(block.begin()[i] == byte(42));
+
+        mmap_heap::deallocate(huge_handle, std::move(block));
+    }
+}
+#endif
@@ -5,6 +5,9 @@
 #include <foonathan/array/block_storage_new.hpp>
 
 #include <catch.hpp>
+#include <cstdint>
+
+#include <foonathan/array/array.hpp>
 
 #include "block_storage_algorithm.hpp"
 
@@ -18,3 +21,20 @@ TEST_CASE("block_storage_new", "[BlockStorage]")
     test::test_block_storage_algorithm<block_storage_new<default_growth>>({});
     test::test_block_storage_algorithm<block_storage_new<no_extra_growth>>({});
 }
+
+TEST_CASE("block_storage_new over-aligned", "[BlockStorage]")
+{
+    struct alignas(64) counter
+    {
+        std::uint64_t value;
+    };
+
+    array<counter, block_storage_new<default_growth>> a;
+    for (auto i = 0u; i != 100u; ++i)
+    {
+        a.push_back(counter{i});
+        REQUIRE(reinterpret_cast<std::uintptr_t>(iterator_to_pointer(a.begin())) % 64u == 0u);
+    }
+    for (auto i = 0u; i != 100u; ++i)
+        REQUIRE(a[i].value == i);
+}
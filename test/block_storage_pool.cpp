@@ -0,0 +1,115 @@
+// Copyright (C) 2018 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#include <foonathan/array/block_storage_pool.hpp>
+
+#include <catch.hpp>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <foonathan/array/array.hpp>
+
+#include "block_storage_algorithm.hpp"
+
+using namespace foonathan::array;
+
+TEST_CASE("block_storage_pool", "[BlockStorage]")
+{
+    REQUIRE(sizeof(block_storage_pool<default_growth>) == sizeof(memory_block));
+
+    test::test_block_storage_algorithm<block_storage_pool<default_growth>>({});
+    test::test_block_storage_algorithm<block_storage_pool<no_extra_growth>>({});
+
+    pool_heap::handle_type handle;
+
+    SECTION("size classes")
+    {
+        auto a = pool_heap::allocate(handle, 1u, 1u);
+        REQUIRE(a.size() == 16u);
+        auto b = pool_heap::allocate(handle, 17u, 8u);
+        REQUIRE(b.size() == 32u);
+        auto c = pool_heap::allocate(handle, pool_heap::max_pooled_size + 1u, 8u);
+        REQUIRE(c.size() == pool_heap::max_pooled_size + 1u);
+
+        pool_heap::deallocate(handle, std::move(a));
+        pool_heap::deallocate(handle, std::move(b));
+        pool_heap::deallocate(handle, std::move(c));
+    }
+    SECTION("good_size")
+    {
+        REQUIRE(pool_heap::good_size(handle, 1u) == 16u);
+        REQUIRE(pool_heap::good_size(handle, 100u) == 128u);
+        REQUIRE(pool_heap::good_size(handle, pool_heap::max_pooled_size + 1u)
+                == pool_heap::max_pooled_size + 1u);
+
+        array<char, block_storage_pool<no_extra_growth>> a;
+        a.reserve(100u);
+        REQUIRE(a.capacity() == 128u);
+    }
+    SECTION("reuse")
+    {
+        auto a     = pool_heap::allocate(handle, 100u, 8u);
+        auto begin = a.begin();
+        pool_heap::deallocate(handle, std::move(a));
+
+        auto b = pool_heap::allocate(handle, 128u, 8u);
+        REQUIRE(b.begin() == begin);
+        pool_heap::deallocate(handle, std::move(b));
+    }
+    SECTION("remote free")
+    {
+        auto block = pool_heap::allocate(handle, 64u, 8u);
+        auto begin = block.begin();
+
+        std::thread([&] { pool_heap::deallocate(handle, std::move(block)); }).join();
+
+        // returned to this thread
+        auto b = pool_heap::allocate(handle, 64u, 8u);
+        REQUIRE(b.begin() == begin);
+        pool_heap::deallocate(handle, std::move(b));
+    }
+    SECTION("multiple threads")
+    {
+        std::mutex                mutex;
+        std::vector<memory_block> shared;
+
+        auto worker = [&](int id) {
+            pool_heap::handle_type h;
+            for (auto i = 0; i != 1000; ++i)
+            {
+                auto block = pool_heap::allocate(h, size_type(16 << (i % 8)), 8u);
+                std::memset(to_void_pointer(block.begin()), id, block.size());
+
+                std::lock_guard<std::mutex> lock(mutex);
+                shared.push_back(block);
+                if (shared.size() > 10u)
+                {
+                    // free a block of (probably) another thread
+                    auto other = shared.front();
+                    shared.erase(shared.begin());
+                    pool_heap::deallocate(h, std::move(other));
+                }
+            }
+        };
+
+        std::vector<std::thread> threads;
+        for (auto i = 0; i != 4; ++i)
+            threads.emplace_back(worker, i);
+        for (auto& t : threads)
+            t.join();
+
+        for (auto& block : shared)
+            pool_heap::deallocate(handle, std::move(block));
+    }
+    SECTION("array")
+    {
+        array<int, block_storage_pool<default_growth>> a;
+        for (auto i = 0; i != 10000; ++i)
+            a.push_back(i);
+        for (auto i = 0; i != 10000; ++i)
+            REQUIRE(a[size_type(i)] == i);
+    }
+}
@@ -0,0 +1,76 @@
+// Copyright (C) 2018 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#include <foonathan/array/block_storage_shared_memory.hpp>
+
+#include <catch.hpp>
+#include <cstdint>
+
+#include <sys/wait.h>
+
+#include <foonathan/array/array.hpp>
+#include <foonathan/array/flat_set.hpp>
+
+using namespace foonathan::array;
+
+TEST_CASE("block_storage_shared_memory", "[BlockStorage]")
+{
+    SECTION("anonymous")
+    {
+        mapped_file memory(anonymous_shared_memory());
+
+        flat_set<std::uint32_t, key_compare_default, block_storage_shared_memory<>> set(
+            block_storage_arg(&memory));
+        for (auto i = 0u; i != 1000u; ++i)
+            set.insert(999u - i);
+        set.shrink_to_fit();
+
+        auto pid = ::fork();
+        REQUIRE(pid != -1);
+        if (pid == 0)
+        {
+            // the child maps the inherited descriptor
+            mapped_array_view<std::uint32_t> view(memory.native_handle());
+
+            auto equal = view.size() == 1000u;
+            for (auto i = 0u; equal && i != 1000u; ++i)
+                equal = view.data()[i] == i;
+            ::_exit(equal ? 0 : 1);
+        }
+
+        auto status = 0;
+        REQUIRE(::waitpid(pid, &status, 0) == pid);
+        REQUIRE(WIFEXITED(status));
+        REQUIRE(WEXITSTATUS(status) == 0);
+    }
+    SECTION("named")
+    {
+        auto name = "/foonathan_array_test_" + std::to_string(::getpid());
+        unlink_shared_memory(name.c_str());
+
+        mapped_file memory(open_shared_memory(name.c_str()));
+
+        array<std::uint64_t, block_storage_shared_memory<>> a(block_storage_arg(&memory));
+        for (auto i = 0u; i != 100u; ++i)
+            a.push_back(i * i);
+        a.shrink_to_fit();
+
+        // the view shares the memory, so it sees later changes
+        auto fd = open_shared_memory(name.c_str(), O_RDONLY);
+        mapped_array_view<std::uint64_t> view(fd);
+        ::close(fd);
+        REQUIRE(view.size() == 100u);
+        REQUIRE(view.data()[10] == 100u);
+
+        a[10] = 42u;
+        REQUIRE(view.data()[10] == 42u);
+
+        array_view<const std::uint64_t> data = view;
+        REQUIRE(data.size() == 100u);
+        REQUIRE(data[99] == 99u * 99u);
+
+        unlink_shared_memory(name.c_str());
+        REQUIRE_THROWS_AS(open_shared_memory(name.c_str(), O_RDONLY), std::system_error);
+    }
+}
@@ -0,0 +1,71 @@
+// Copyright (C) 2018 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#include <foonathan/array/block_storage_vm.hpp>
+
+#include <catch.hpp>
+#include <cstdint>
+#include <vector>
+
+#include <foonathan/array/array.hpp>
+
+#include "block_storage_algorithm.hpp"
+
+using namespace foonathan::array;
+
+TEST_CASE("block_storage_vm", "[BlockStorage]")
+{
+    REQUIRE(sizeof(block_storage_vm<1024u>) == sizeof(memory_block));
+
+    test::test_block_storage_algorithm<block_storage_vm<1024u * 1024u>>({});
+
+    SECTION("pointer stability")
+    {
+        array<std::uint64_t, block_storage_vm<std::size_t(1) << 30>> a;
+        a.push_back(0u);
+        auto data = iterator_to_pointer(a.begin());
+
+        for (auto i = 1u; i != 100000u; ++i)
+            a.push_back(i);
+        REQUIRE(iterator_to_pointer(a.begin()) == data);
+
+        auto equal = true;
+        for (auto i = 0u; i != 100000u; ++i)
+            equal = equal && a[i] == i;
+        REQUIRE(equal);
+
+        a.erase_range(a.begin() + 10, a.end());
+        a.shrink_to_fit();
+        REQUIRE(iterator_to_pointer(a.begin()) == data);
+        REQUIRE(a.capacity() < 100000u);
+        for (auto i = 0u; i != 10u; ++i)
+            REQUIRE(a[i] == i);
+
+        a.push_back(10u);
+        REQUIRE(iterator_to_pointer(a.begin()) == data);
+        REQUIRE(a.back() == 10u);
+    }
+    SECTION("reserve on non-empty array")
+    {
+        array<std::uint64_t, block_storage_vm<std::size_t(1) << 30>> a;
+        a.push_back(0u);
+
+        a.reserve(100000u);
+        REQUIRE(a.capacity() >= 100000u);
+
+        std::vector<std::uint64_t> values(99999u, 0u);
+        a.append_range(values.begin(), values.end());
+        REQUIRE(a.size() == 100000u);
+        REQUIRE(a.back() == 0u);
+    }
+    SECTION("overflow")
+    {
+        array<std::uint64_t, block_storage_vm<64u>> a;
+        for (auto i = 0u; i != 8u; ++i)
+            a.push_back(i);
+        REQUIRE(a.capacity() == 8u);
+        REQUIRE_THROWS_AS(a.push_back(8u), vm_storage_overflow);
+        REQUIRE(a.size() == 8u);
+    }
+}
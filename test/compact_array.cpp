@@ -0,0 +1,96 @@
+// Copyright (C) 2018 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#include <foonathan/array/compact_array.hpp>
+
+#include <catch.hpp>
+#include <cstdint>
+#include <string>
+
+#include <foonathan/array/block_storage_malloc.hpp>
+
+#include "leak_checker.hpp"
+
+using namespace foonathan::array;
+
+namespace
+{
+    struct tracked : leak_tracked
+    {
+        std::string value;
+
+        tracked(int i) : value(std::to_string(i)) {}
+    };
+
+    template <class Array>
+    void test_compact_array()
+    {
+        Array a;
+        REQUIRE(a.empty());
+        REQUIRE(a.capacity() == 0u);
+
+        for (auto i = 0; i != 100; ++i)
+            a.emplace_back(i);
+        REQUIRE(a.size() == 100u);
+        REQUIRE(a.capacity() >= 100u);
+        for (auto i = 0; i != 100; ++i)
+            REQUIRE(a[std::size_t(i)] == i);
+
+        auto copy = a;
+        REQUIRE(copy.size() == 100u);
+
+        auto iter = a.erase_range(a.cbegin() + 10, a.cbegin() + 20);
+        REQUIRE(*iter == 20);
+        REQUIRE(a.size() == 90u);
+        a.erase(a.cbegin());
+        REQUIRE(a.front() == 1);
+        a.pop_back();
+        REQUIRE(a.back() == 98);
+
+        a.shrink_to_fit();
+        REQUIRE(a.capacity() >= a.size());
+        REQUIRE(a[8u] == 9);
+
+        a = std::move(copy);
+        REQUIRE(a.size() == 100u);
+        REQUIRE(copy.empty());
+
+        a.clear();
+        REQUIRE(a.empty());
+        a.shrink_to_fit();
+        REQUIRE(a.capacity() == 0u);
+    }
+} // namespace
+
+TEST_CASE("compact_array", "[container]")
+{
+    REQUIRE(sizeof(compact_array<int>) == sizeof(int*) + 2 * sizeof(std::uint32_t));
+    REQUIRE(compact_array<int>::max_size() <= UINT32_MAX);
+
+    test_compact_array<compact_array<int>>();
+    test_compact_array<compact_array<int, malloc_heap>>();
+    test_compact_array<compact_array<int, new_heap, no_extra_growth>>();
+}
+
+TEST_CASE("compact_array non-trivial", "[container]")
+{
+    leak_checker checker;
+
+    compact_array<tracked> a;
+    for (auto i = 0; i != 20; ++i)
+        a.push_back(tracked(i));
+
+    int values[] = {1, 2, 3};
+    a.append_range(std::begin(values), std::end(values));
+    REQUIRE(a.size() == 23u);
+    REQUIRE(a.back().value == "3");
+
+    a.erase(a.cbegin() + 5);
+    REQUIRE(a[5u].value == "6");
+
+    compact_array<tracked> b(a);
+    REQUIRE(b.size() == 22u);
+    b = a;
+    REQUIRE(b[21u].value == "3");
+}
@@ -5,6 +5,7 @@
 #include <foonathan/array/flat_map.hpp>
 
 #include <catch.hpp>
+#include <vector>
 
 #include "equal_checker.hpp"
 #include "leak_checker.hpp"
@@ -335,3 +336,122 @@ TEST_CASE("flat_map", "[container]")
         }
     }
 }
+
+TEST_CASE("flat_map bulk operations", "[container]")
+{
+    leak_checker checker;
+
+    test_map map;
+    map.insert(0xF1F1, "a");
+    map.insert(0xF3F3, "b");
+
+    int         keys[]   = {0xF4F4, 0xF1F1, 0xF0F0, 0xF4F4, 0xF2F2};
+    std::string values[] = {"c", "d", "e", "f", "g"};
+
+    SECTION("insert_range")
+    {
+        map.insert_range(std::begin(keys), std::end(keys), std::begin(values), std::end(values));
+        verify_map(map, {0xF0F0, 0xF1F1, 0xF2F2, 0xF3F3, 0xF4F4}, {"e", "a", "g", "b", "c"});
+
+        // stops at the shorter range
+        int more_keys[] = {0xF6F6, 0xF5F5};
+        map.insert_range(std::begin(more_keys), std::end(more_keys), std::begin(values),
+                         std::begin(values) + 1);
+        verify_map(map, {0xF0F0, 0xF1F1, 0xF2F2, 0xF3F3, 0xF4F4, 0xF6F6},
+                   {"e", "a", "g", "b", "c", "c"});
+    }
+    SECTION("insert_or_assign_range")
+    {
+        map.insert_or_assign_range(std::begin(keys), std::end(keys), std::begin(values),
+                                   std::end(values));
+        verify_map(map, {0xF0F0, 0xF1F1, 0xF2F2, 0xF3F3, 0xF4F4}, {"e", "d", "g", "b", "f"});
+
+        std::pair<int, std::string> pairs[] = {{0xF3F3, "h"}, {0xF5F5, "i"}};
+        map.insert_or_assign_pair_range(std::begin(pairs), std::end(pairs));
+        verify_map(map, {0xF0F0, 0xF1F1, 0xF2F2, 0xF3F3, 0xF4F4, 0xF5F5},
+                   {"e", "d", "g", "h", "f", "i"});
+    }
+    SECTION("assign_range")
+    {
+        map.assign_range(std::begin(keys), std::end(keys), std::begin(values), std::end(values));
+        verify_map(map, {0xF0F0, 0xF1F1, 0xF2F2, 0xF4F4}, {"e", "d", "g", "c"});
+
+        map.assign_range(std::begin(keys), std::end(keys), std::begin(values), std::end(values),
+                         duplicate_policy::keep_last);
+        verify_map(map, {0xF0F0, 0xF1F1, 0xF2F2, 0xF4F4}, {"e", "d", "g", "f"});
+    }
+    SECTION("exception")
+    {
+        struct throwing_value
+        {
+            int value;
+
+            throwing_value(int value) : value(value) {}
+
+            throwing_value(const throwing_value& other) : value(other.value)
+            {
+                if (value < 0)
+                    throw 0;
+            }
+
+            throwing_value& operator=(const throwing_value&) = default;
+        };
+
+        flat_map<int, throwing_value> throwing;
+        throwing.insert(1, 1);
+        throwing.insert(3, 3);
+
+        int throwing_keys[]   = {2, 0, 4};
+        int throwing_values[] = {2, 0, -1};
+        REQUIRE_THROWS(throwing.insert_range(std::begin(throwing_keys), std::end(throwing_keys),
+                                             std::begin(throwing_values),
+                                             std::end(throwing_values)));
+        REQUIRE(throwing.size() == 2u);
+        REQUIRE(throwing.lookup(1).value == 1);
+        REQUIRE(throwing.lookup(3).value == 3);
+    }
+    SECTION("multimap")
+    {
+        flat_multimap<int, int> multi;
+        multi.insert(1, 0);
+        multi.insert(2, 0);
+
+        int multi_keys[]   = {2, 1, 2, 0};
+        int multi_values[] = {1, 2, 3, 4};
+        multi.insert_range(std::begin(multi_keys), std::end(multi_keys), std::begin(multi_values),
+                           std::end(multi_values));
+
+        auto expected_keys   = {0, 1, 1, 2, 2, 2};
+        auto expected_values = {4, 0, 2, 0, 1, 3};
+        REQUIRE(multi.size() == expected_keys.size());
+        for (auto i = 0u; i != multi.size(); ++i)
+        {
+            REQUIRE(multi.keys()[i] == expected_keys.begin()[i]);
+            REQUIRE(multi.values()[i] == expected_values.begin()[i]);
+        }
+    }
+}
+
+TEST_CASE("flat_map radix sort", "[container]")
+{
+    std::vector<std::uint64_t> keys;
+    std::vector<int>           values;
+    for (auto i = 0; i != 1000; ++i)
+    {
+        keys.push_back(std::uint64_t(i * 7919) % 997u);
+        values.push_back(i);
+    }
+
+    flat_map<std::uint64_t, int> map;
+    map.assign_range(keys.begin(), keys.end(), values.begin(), values.end());
+    REQUIRE(map.size() == 997u);
+    REQUIRE(std::is_sorted(map.keys().begin(), map.keys().end()));
+    for (auto i = 0; i != 3; ++i)
+        REQUIRE(keys[std::size_t(map.lookup(keys[std::size_t(i)]))] == keys[std::size_t(i)]);
+    // the first one is kept
+    REQUIRE(map.lookup(keys[997]) == 0);
+
+    map.assign_range(keys.begin(), keys.end(), values.begin(), values.end(),
+                     duplicate_policy::keep_last);
+    REQUIRE(map.lookup(keys[0]) == 997);
+}
@@ -4,7 +4,11 @@
 
 #include <foonathan/array/flat_set.hpp>
 
+#include <algorithm>
 #include <catch.hpp>
+#include <iterator>
+#include <sstream>
+#include <vector>
 
 #include "equal_checker.hpp"
 #include "leak_checker.hpp"
@@ -358,3 +362,259 @@ TEST_CASE("flat_multiset", "[container]")
     verify_set(set, {0xF0F0, 0xF0F0, 0xF1F1, 0xF1F1, 0xF2F2, 0xF3F3});
     verify_result(set, result, 0xF1F1, 3, true);
 }
+
+TEST_CASE("flat_set bulk insert_range", "[container]")
+{
+    leak_checker checker;
+
+    SECTION("set")
+    {
+        test_set set{{test_type(0xF2F2), test_type(0xF5F5)}};
+
+        test_type tests[] = {0xF7F7, 0xF1F1, 0xF5F5, 0xF3F3, 0xF1F1, 0xF0F0};
+        set.insert_range(std::begin(tests), std::end(tests));
+        verify_set(set, {0xF0F0, 0xF1F1, 0xF2F2, 0xF3F3, 0xF5F5, 0xF7F7});
+
+        // only bigger keys
+        test_type bigger[] = {0xF9F9, 0xF8F8};
+        set.insert(bigger);
+        verify_set(set, {0xF0F0, 0xF1F1, 0xF2F2, 0xF3F3, 0xF5F5, 0xF7F7, 0xF8F8, 0xF9F9});
+
+        // nothing
+        set.insert_range(std::begin(tests), std::begin(tests));
+        REQUIRE(set.size() == 8u);
+    }
+    SECTION("multiset")
+    {
+        test_multiset set{{test_type(0xF2F2), test_type(0xF5F5)}};
+
+        test_type tests[] = {0xF5F5, 0xF1F1, 0xF2F2, 0xF1F1};
+        set.insert_range(std::begin(tests), std::end(tests));
+        verify_set(set, {0xF1F1, 0xF1F1, 0xF2F2, 0xF2F2, 0xF5F5, 0xF5F5});
+    }
+    SECTION("key_value_pair")
+    {
+        test_key_value_set set;
+        set.try_emplace(0xF1F1, 1);
+
+        key_value_pair<int, test_type> pairs[] = {key_value_pair<int, test_type>(0xF2F2, 2),
+                                                  key_value_pair<int, test_type>(0xF1F1, 3),
+                                                  key_value_pair<int, test_type>(0xF0F0, 4),
+                                                  key_value_pair<int, test_type>(0xF2F2, 5)};
+        set.insert_range(std::begin(pairs), std::end(pairs));
+        REQUIRE(set.size() == 3u);
+
+        // the first key is kept
+        REQUIRE(set.lookup(0xF0F0).value.id == 4);
+        REQUIRE(set.lookup(0xF1F1).value.id == 1);
+        REQUIRE(set.lookup(0xF2F2).value.id == 2);
+    }
+    SECTION("exception")
+    {
+        // throws when constructed from a negative integer
+        // or when copied or moved after the given number of copies and moves
+        struct throwing_key
+        {
+            int id;
+
+            static int& countdown()
+            {
+                static int value = -1;
+                return value;
+            }
+
+            static void count()
+            {
+                if (countdown() == 0)
+                    throw 0;
+                else if (countdown() > 0)
+                    --countdown();
+            }
+
+            throwing_key(int i) : id(i)
+            {
+                if (i < 0)
+                    throw 0;
+            }
+
+            throwing_key(const throwing_key& other) : id(other.id)
+            {
+                count();
+            }
+
+            throwing_key& operator=(const throwing_key& other)
+            {
+                count();
+                id = other.id;
+                return *this;
+            }
+
+            bool operator<(const throwing_key& other) const
+            {
+                return id < other.id;
+            }
+            bool operator==(const throwing_key& other) const
+            {
+                return id == other.id;
+            }
+        };
+
+        // an input iterator, so the elements are inserted one by one
+        std::istringstream partial("4 0 -1 2");
+        flat_set<throwing_key> set;
+        set.insert(throwing_key(1));
+        set.insert(throwing_key(3));
+        REQUIRE_THROWS(set.insert_range(std::istream_iterator<int>(partial),
+                                        std::istream_iterator<int>()));
+        REQUIRE(set.size() == 2u);
+        REQUIRE(set.min().id == 1);
+        REQUIRE(set.max().id == 3);
+
+        std::vector<throwing_key> keys;
+        for (auto i = 0; i != 300; ++i)
+            keys.emplace_back((i * 7) % 300);
+
+        for (auto countdown = 0;; countdown += 97)
+        {
+            flat_set<throwing_key> copy;
+            for (auto i = 0; i != 600; i += 5)
+                copy.insert(throwing_key(i));
+
+            throwing_key::countdown() = countdown;
+            try
+            {
+                copy.insert_range(keys.begin(), keys.end());
+                throwing_key::countdown() = -1;
+                REQUIRE(copy.size() == 360u);
+                break;
+            }
+            catch (int)
+            {
+                throwing_key::countdown() = -1;
+
+                // either nothing was inserted or everything is gone, but it is still a set
+                REQUIRE((copy.size() == 120u || copy.empty()));
+                auto sorted =
+                    std::adjacent_find(copy.begin(), copy.end(),
+                                       [](const throwing_key& lhs, const throwing_key& rhs) {
+                                           return !(lhs < rhs);
+                                       })
+                    == copy.end();
+                REQUIRE(sorted);
+            }
+        }
+    }
+}
+
+TEST_CASE("flat_set assign", "[container]")
+{
+    leak_checker checker;
+
+    test_set set;
+    SECTION("sorted")
+    {
+        set.assign({test_type(0xF0F0), test_type(0xF1F1), test_type(0xF1F1), test_type(0xF2F2)});
+        verify_set(set, {0xF0F0, 0xF1F1, 0xF2F2});
+    }
+    SECTION("reverse sorted")
+    {
+        set.assign({test_type(0xF3F3), test_type(0xF2F2), test_type(0xF1F1), test_type(0xF0F0)});
+        verify_set(set, {0xF0F0, 0xF1F1, 0xF2F2, 0xF3F3});
+    }
+    SECTION("unsorted")
+    {
+        set.assign({test_type(0xF2F2), test_type(0xF0F0), test_type(0xF2F2), test_type(0xF1F1)});
+        verify_set(set, {0xF0F0, 0xF1F1, 0xF2F2});
+    }
+    SECTION("assign_range")
+    {
+        test_type tests[] = {0xF1F1, 0xF0F0, 0xF1F1};
+        set.assign_range(std::begin(tests), std::end(tests));
+        verify_set(set, {0xF0F0, 0xF1F1});
+    }
+    SECTION("key_value_pair")
+    {
+        using pair = key_value_pair<int, test_type>;
+
+        test_key_value_set pairs;
+        pairs.assign({pair(2, 0), pair(1, 1), pair(2, 2), pair(0, 3), pair(1, 4)});
+        REQUIRE(pairs.size() == 3u);
+        REQUIRE(pairs.lookup(0).value.id == 3);
+        REQUIRE(pairs.lookup(1).value.id == 1);
+        REQUIRE(pairs.lookup(2).value.id == 0);
+
+        // reverse sorted with duplicates, must still keep the first
+        pairs.assign({pair(2, 0), pair(1, 1), pair(1, 2), pair(0, 3)});
+        REQUIRE(pairs.size() == 3u);
+        REQUIRE(pairs.lookup(1).value.id == 1);
+    }    SECTION("exception")
+    {
+        struct throwing_copy
+        {
+            int id;
+
+            throwing_copy(int i) : id(i) {}
+
+            throwing_copy(const throwing_copy& other) : id(other.id)
+            {
+                if (id < 0)
+                    throw 0;
+            }
+
+            throwing_copy& operator=(const throwing_copy&) = default;
+
+            bool operator<(const throwing_copy& other) const
+            {
+                return id < other.id;
+            }
+            bool operator==(const throwing_copy& other) const
+            {
+                return id == other.id;
+            }
+        };
+
+        flat_set<throwing_copy> throwing;
+        throwing.insert(throwing_copy(1));
+        throwing.insert(throwing_copy(2));
+
+        REQUIRE_THROWS(throwing.assign({throwing_copy(3), throwing_copy(0), throwing_copy(-1)}));
+        REQUIRE(throwing.empty());
+    }
+}
+
+TEST_CASE("flat_set radix sort", "[container]")
+{
+    std::vector<int> values;
+    for (auto i = 0; i != 1000; ++i)
+        values.push_back((i * 7919) % 1009 - 500);
+    values.push_back(0);
+
+    flat_set<int> set;
+    set.assign_range(values.begin(), values.end());
+    REQUIRE(set.size() == 1000u);
+    REQUIRE(std::is_sorted(set.begin(), set.end()));
+    REQUIRE(std::adjacent_find(set.begin(), set.end()) == set.end());
+
+    flat_multiset<double> multiset;
+    multiset.insert_range(values.begin(), values.end());
+    REQUIRE(multiset.size() == 1001u);
+    REQUIRE(std::is_sorted(multiset.begin(), multiset.end()));
+    REQUIRE(multiset.min() == -500.0);
+
+    // sorted by the key, the first of equivalent keys is kept
+    using pair = key_value_pair<int, int>;
+    REQUIRE(key_compare_radix<key_compare_default, pair>::value);
+    REQUIRE(std::is_trivially_copyable<pair>::value);
+
+    std::vector<pair> pairs;
+    for (auto i = 0; i != 1001; ++i)
+        pairs.emplace_back(values[std::size_t(i)], i);
+
+    flat_set<pair> pair_set;
+    pair_set.assign_range(pairs.begin(), pairs.end());
+    REQUIRE(pair_set.size() == 1000u);
+    REQUIRE(std::is_sorted(pair_set.begin(), pair_set.end(),
+                           [](const pair& lhs, const pair& rhs) { return lhs.key < rhs.key; }));
+    REQUIRE(pair_set.lookup(-500).value == 0);
+    REQUIRE(pair_set.lookup(0).value != 1000);
+}
@@ -26,8 +26,8 @@ TEST_CASE("factor_growth", "[GrowthPolicy]")
     REQUIRE(factor1dot5::growth_size(5u, 1u, memory_block::max_size()) == 7u);
     REQUIRE(factor1dot5::growth_size(4u, 8u, memory_block::max_size()) == 12u);
 
-    REQUIRE(factor1dot5::shrink_size(4u, 2u) == 2u);
-    REQUIRE(factor1dot5::shrink_size(8u, 8u) == 8u);
+    REQUIRE(factor1dot5::shrink_size(4u, 2u, memory_block::max_size()) == 2u);
+    REQUIRE(factor1dot5::shrink_size(8u, 8u, memory_block::max_size()) == 8u);
 
     using factor2 = factor_growth<4, 2>;
 
@@ -35,8 +35,8 @@ TEST_CASE("factor_growth", "[GrowthPolicy]")
     REQUIRE(factor2::growth_size(4u, 1u, memory_block::max_size()) == 8u);
     REQUIRE(factor2::growth_size(4u, 8u, memory_block::max_size()) == 12u);
 
-    REQUIRE(factor2::shrink_size(4u, 2u) == 2u);
-    REQUIRE(factor2::shrink_size(8u, 8u) == 8u);
+    REQUIRE(factor2::shrink_size(4u, 2u, memory_block::max_size()) == 2u);
+    REQUIRE(factor2::shrink_size(8u, 8u, memory_block::max_size()) == 8u);
 
     SECTION("whole_growth")
     {
@@ -70,3 +70,23 @@ TEST_CASE("factor_growth", "[GrowthPolicy]")
         REQUIRE(detail::frac_growth<5, 3>::grow(5u) == 8); // 8.3..
     }
 }
+
+TEST_CASE("hysteresis_growth", "[GrowthPolicy]")
+{
+    using policy = hysteresis_growth<>;
+
+    REQUIRE(policy::growth_size(4u, 1u, memory_block::max_size()) == 8u);
+    REQUIRE(policy::growth_size(4u, 8u, memory_block::max_size()) == 12u);
+
+    // at least a quarter used
+    REQUIRE(policy::shrink_size(64u, 64u, memory_block::max_size()) == 64u);
+    REQUIRE(policy::shrink_size(64u, 16u, memory_block::max_size()) == 64u);
+    // shrink to 1.5x
+    REQUIRE(policy::shrink_size(64u, 15u, memory_block::max_size()) == 22u);
+    REQUIRE(policy::shrink_size(64u, 8u, memory_block::max_size()) == 12u);
+    REQUIRE(policy::shrink_size(64u, 0u, memory_block::max_size()) == 0u);
+    REQUIRE(policy::shrink_size(64u, 8u, 10u) == 10u);
+
+    REQUIRE(!detail::growth_auto_shrink<policy>::value);
+    REQUIRE(detail::growth_auto_shrink<auto_shrink_growth<policy>>::value);
+}
@@ -6,6 +6,8 @@
 
 #include <foonathan/array/key_compare.hpp>
 
+#include <algorithm>
+#include <random>
 #include <vector>
 
 using namespace foonathan::array;
@@ -140,3 +142,70 @@ TEST_CASE("sorted_view", "[view]")
     REQUIRE(view.min() == 1);
     REQUIRE(view.max() == 4);
 }
+
+TEST_CASE("key_compare_radix", "[util]")
+{
+    struct custom_compare
+    {
+        static key_ordering compare(int lhs, int rhs) noexcept
+        {
+            return key_compare_default::compare(lhs, rhs);
+        }
+    };
+
+    REQUIRE(key_compare_radix<key_compare_default, int>::value);
+    REQUIRE(key_compare_radix<key_compare_default, std::uint8_t>::value);
+    REQUIRE(key_compare_radix<key_compare_default, double>::value);
+    REQUIRE(!key_compare_radix<key_compare_default, bool>::value);
+    REQUIRE(!key_compare_radix<key_compare_default, int*>::value);
+    REQUIRE(!key_compare_radix<custom_compare, int>::value);
+
+    auto check_order = [](std::vector<double> values) {
+        for (auto i = 1u; i < values.size(); ++i)
+            REQUIRE(key_compare_default::customize_for<double>::radix_key(values[i - 1u])
+                    < key_compare_default::customize_for<double>::radix_key(values[i]));
+    };
+    check_order({-std::numeric_limits<double>::infinity(), -1e10, -1.5, -1.0, -1e-300, 0.0, 1e-300,
+                 0.5, 1.0, 1e10, std::numeric_limits<double>::infinity()});
+    REQUIRE(key_compare_default::customize_for<double>::radix_key(-0.0)
+            == key_compare_default::customize_for<double>::radix_key(0.0));
+    REQUIRE(key_compare_default::customize_for<float>::radix_key(-1.f)
+            < key_compare_default::customize_for<float>::radix_key(1.f));
+    REQUIRE(key_compare_default::customize_for<int>::radix_key(-1)
+            < key_compare_default::customize_for<int>::radix_key(0));
+    REQUIRE(key_compare_default::customize_for<long long>::radix_key(
+                std::numeric_limits<long long>::min())
+            < key_compare_default::customize_for<long long>::radix_key(
+                  std::numeric_limits<long long>::max()));
+}
+
+TEST_CASE("radix_sort", "[util]")
+{
+    std::mt19937                       engine(42u);
+    std::uniform_int_distribution<int> dist(-100000, 100000);
+
+    std::vector<int> values(1000u);
+    for (auto& value : values)
+        value = dist(engine);
+    auto expected = values;
+    std::sort(expected.begin(), expected.end());
+
+    std::vector<int> buffer(values.size());
+    detail::radix_sort(values.data(), values.data() + values.size(), buffer.data(),
+                       [](int i) { return key_compare_default::customize_for<int>::radix_key(i); });
+    REQUIRE(values == expected);
+
+    // stable
+    std::vector<detail::radix_record<std::uint8_t>> records;
+    for (auto i = 0u; i != 1000u; ++i)
+        records.push_back({std::uint8_t(dist(engine)), i});
+    std::vector<detail::radix_record<std::uint8_t>> record_buffer(records.size());
+    detail::radix_sort(records.data(), records.data() + records.size(), record_buffer.data(),
+                       [](const detail::radix_record<std::uint8_t>& r) { return r.key; });
+    for (auto i = 1u; i != records.size(); ++i)
+    {
+        REQUIRE(records[i - 1u].key <= records[i].key);
+        if (records[i - 1u].key == records[i].key)
+            REQUIRE(records[i - 1u].index < records[i].index);
+    }
+}
@@ -505,3 +505,109 @@ TEST_CASE("uninitialized_destructive_move", "[core]")
 
     destroy_range(ptr, ptr + 4);
 }
+
+TEST_CASE("is_trivially_relocatable", "[core]")
+{
+    struct non_trivial
+    {
+        non_trivial(const non_trivial&) {}
+    };
+
+    REQUIRE(is_trivially_relocatable<int>::value);
+    REQUIRE(!is_trivially_relocatable<non_trivial>::value);
+    REQUIRE(is_trivially_relocatable<std::unique_ptr<int>>::value);
+    REQUIRE(is_trivially_relocatable<std::shared_ptr<int>>::value);
+    REQUIRE(is_trivially_relocatable<std::pair<int, std::unique_ptr<int>>>::value);
+    REQUIRE(!is_trivially_relocatable<std::pair<int, non_trivial>>::value);
+}
+
+TEST_CASE("uninitialized_destructive_move relocatable", "[core]")
+{
+    using test_type = std::unique_ptr<int>;
+
+    std::aligned_storage<8 * sizeof(test_type), alignof(test_type)>::type storage{};
+
+    auto old_block = memory_block(to_raw_pointer(&storage), 4 * sizeof(test_type));
+    for (auto i = 0; i != 4; ++i)
+        paren_construct_object<test_type>(old_block.begin() + std::size_t(i) * sizeof(test_type),
+                                          new int(i));
+
+    auto new_block =
+        memory_block(to_raw_pointer(&storage) + 4 * sizeof(test_type), 4 * sizeof(test_type));
+    auto end = uninitialized_destructive_move(to_pointer<test_type>(old_block.begin()),
+                                              to_pointer<test_type>(old_block.end()), new_block);
+    REQUIRE(end == new_block.end());
+
+    auto ptr = to_pointer<test_type>(new_block.begin());
+    for (auto i = 0; i != 4; ++i)
+        REQUIRE(*ptr[i] == i);
+
+    destroy_range(ptr, ptr + 4);
+}
+
+TEST_CASE("uninitialized_destructive_move_with_gap", "[core]")
+{
+    SECTION("non-relocatable")
+    {
+        leak_checker checker;
+
+        struct test_type : leak_tracked
+        {
+            int id;
+
+            test_type(int id) : id(id) {}
+        };
+        REQUIRE(!is_trivially_relocatable<test_type>::value);
+
+        std::aligned_storage<10 * sizeof(test_type), alignof(test_type)>::type storage{};
+
+        auto old_block = memory_block(to_raw_pointer(&storage), 4 * sizeof(test_type));
+        for (auto i = 0; i != 4; ++i)
+            paren_construct_object<test_type>(old_block.begin()
+                                                  + std::size_t(i) * sizeof(test_type),
+                                              i);
+
+        auto new_block =
+            memory_block(to_raw_pointer(&storage) + 4 * sizeof(test_type), 6 * sizeof(test_type));
+        auto old_ptr = to_pointer<test_type>(old_block.begin());
+        auto end     = uninitialized_destructive_move_with_gap(old_ptr, old_ptr + 1, old_ptr + 4,
+                                                           2 * sizeof(test_type), new_block);
+        REQUIRE(end == new_block.end());
+
+        auto ptr = to_pointer<test_type>(new_block.begin());
+        REQUIRE(ptr[0].id == 0);
+        REQUIRE(ptr[3].id == 1);
+        REQUIRE(ptr[4].id == 2);
+        REQUIRE(ptr[5].id == 3);
+
+        destroy_range(ptr, ptr + 1);
+        destroy_range(ptr + 3, ptr + 6);
+    }
+    SECTION("relocatable")
+    {
+        using test_type = std::unique_ptr<int>;
+
+        std::aligned_storage<10 * sizeof(test_type), alignof(test_type)>::type storage{};
+
+        auto old_block = memory_block(to_raw_pointer(&storage), 4 * sizeof(test_type));
+        for (auto i = 0; i != 4; ++i)
+            paren_construct_object<test_type>(old_block.begin()
+                                                  + std::size_t(i) * sizeof(test_type),
+                                              new int(i));
+
+        auto new_block =
+            memory_block(to_raw_pointer(&storage) + 4 * sizeof(test_type), 6 * sizeof(test_type));
+        auto old_ptr = to_pointer<test_type>(old_block.begin());
+        auto end     = uninitialized_destructive_move_with_gap(old_ptr, old_ptr + 3, old_ptr + 4,
+                                                           2 * sizeof(test_type), new_block);
+        REQUIRE(end == new_block.end());
+
+        auto ptr = to_pointer<test_type>(new_block.begin());
+        for (auto i = 0; i != 3; ++i)
+            REQUIRE(*ptr[i] == i);
+        REQUIRE(*ptr[5] == 3);
+
+        destroy_range(ptr, ptr + 3);
+        destroy_range(ptr + 5, ptr + 6);
+    }
+}
@@ -0,0 +1,125 @@
+// Copyright (C) 2018 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#include <foonathan/array/static_vector.hpp>
+
+#include <catch.hpp>
+#include <cstdint>
+
+#include "leak_checker.hpp"
+
+using namespace foonathan::array;
+
+namespace
+{
+    struct tracked : leak_tracked
+    {
+        int value;
+
+        tracked(int i) : value(i) {}
+    };
+
+#if FOONATHAN_ARRAY_USE_CONSTEXPR14
+    constexpr int constexpr_sum()
+    {
+        static_vector<int, 8> vec{1, 2, 3};
+        vec.push_back(4);
+        vec.erase(vec.cbegin());
+        while (vec.try_push_back(0))
+        {
+        }
+
+        auto sum = 0;
+        for (auto i : vec)
+            sum += i;
+        return sum + int(vec.size());
+    }
+    static_assert(constexpr_sum() == 2 + 3 + 4 + 8, "");
+#endif
+} // namespace
+
+TEST_CASE("static_vector", "[container]")
+{
+    REQUIRE(sizeof(static_vector<std::uint8_t, 15>) == 16u);
+    REQUIRE(sizeof(static_vector<std::uint32_t, 4>) == 4 * sizeof(std::uint32_t) + 4u);
+    REQUIRE(sizeof(static_vector<char, 1000>) == 1000u + sizeof(std::uint16_t));
+    REQUIRE(noexcept(std::declval<static_vector<int, 4>&>().try_emplace_back(0)));
+
+    static_vector<int, 4> vec;
+    REQUIRE(vec.empty());
+    REQUIRE(vec.capacity() == 4u);
+
+    for (auto i = 0; i != 4; ++i)
+        REQUIRE(vec.try_emplace_back(i));
+    REQUIRE(vec.full());
+    REQUIRE(!vec.try_emplace_back(4));
+    REQUIRE(!vec.try_push_back(4));
+    REQUIRE(vec.size() == 4u);
+    REQUIRE(vec.back() == 3);
+
+    auto iter = vec.erase_range(vec.cbegin() + 1, vec.cbegin() + 3);
+    REQUIRE(*iter == 3);
+    REQUIRE(vec.size() == 2u);
+    REQUIRE(vec[0] == 0);
+    REQUIRE(vec[1] == 3);
+
+    array_view<const int> view = vec;
+    REQUIRE(view.size() == 2u);
+    REQUIRE(view.data() == &vec.front());
+
+    vec.clear();
+    REQUIRE(vec.empty());
+}
+
+TEST_CASE("static_vector non-trivial", "[container]")
+{
+    leak_checker checker;
+
+    static_vector<tracked, 3> vec;
+    vec.emplace_back(0);
+    vec.push_back(tracked(1));
+    REQUIRE(vec.try_emplace_back(2)->value == 2);
+    REQUIRE(vec.try_emplace_back(3) == nullptr);
+
+    auto copy = vec;
+    REQUIRE(copy.size() == 3u);
+
+    vec.erase(vec.cbegin());
+    REQUIRE(vec.size() == 2u);
+    REQUIRE(vec.front().value == 1);
+    REQUIRE(vec.back().value == 2);
+
+    copy = std::move(vec);
+    REQUIRE(copy.size() == 2u);
+    REQUIRE(copy[0].value == 1);
+
+    copy.pop_back();
+    REQUIRE(copy.size() == 1u);
+
+    // copying throws at the second element
+    struct throwing : leak_tracked
+    {
+        int value;
+
+        throwing(int i) : value(i) {}
+
+        throwing(const throwing& other) : leak_tracked(other), value(other.value)
+        {
+            if (value < 0)
+                throw 0;
+        }
+
+        throwing& operator=(const throwing&) = default;
+    };
+
+    static_vector<throwing, 3> throwing_vec;
+    throwing_vec.emplace_back(0);
+    throwing_vec.emplace_back(-1);
+    REQUIRE_THROWS(static_vector<throwing, 3>(throwing_vec));
+
+    static_vector<throwing, 3> assigned;
+    assigned.emplace_back(1);
+    REQUIRE_THROWS(assigned = throwing_vec);
+    REQUIRE(assigned.empty());
+}